@@ -0,0 +1,213 @@
+#ifndef CHOPS_ARENA_LIST_H
+#define CHOPS_ARENA_LIST_H
+
+/*
+    This file contains the float singly linked list of
+    chops_singlylist with its nodes in an arena, one growable array
+    owned by the list. Since every node lives in the same array,
+    next does not need to be a full pointer: a 32-bit index from
+    the arena base is enough for UINT32_MAX - 1 nodes, a little
+    under 4.3 billion. A node is then 8 bytes instead of 16, twice
+    as many fit in a cache line, and there is no malloc header per
+    node either.
+
+    Index 0 is never handed out, so 0 plays the role of NULL.
+    Pushing to a full arena, or when memory runs out, fails and
+    leaves the list as it was.
+    Because links are relative, the arena can be moved by realloc
+    when it grows without fixing up a single node. Pointers to
+    nodes, on the other hand, are only good until the next push.
+
+    The same property lets an arena be written to a file and used
+    straight from a mapping of it, see chops_list_mmap. Such an
+    arena is borrowed: the list does not free it, and copies it to
+    the heap the first time it has to grow.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#define ALIST_NIL 0
+#define ALIST_INITIAL_CAPACITY 16
+
+typedef struct anode {
+    float value;
+    uint32_t next;
+}  anode_t ;
+
+typedef struct alist {
+   anode_t *base;
+   uint32_t capacity;
+   uint32_t used;      // slot 0 counts as used, it is the NIL
+   uint32_t head;
+   uint32_t tail;
+   size_t length;
+   int borrowed;       // base is not ours to realloc or free
+}  alist_t ;
+
+// NULL if out of memory
+inline alist_t* make_alist()
+{
+	alist_t *list = (alist_t *) calloc(1, sizeof(alist_t));
+	if(list == NULL)
+		return NULL;
+	list->base = (anode_t *) malloc(ALIST_INITIAL_CAPACITY * sizeof(anode_t));
+	if(list->base == NULL)
+	{
+		free(list);
+		return NULL;
+	}
+	list->capacity = ALIST_INITIAL_CAPACITY;
+	list->used = 1;
+	return list;
+}
+
+// One free for the whole arena, no walk
+inline void destroy_alist(alist_t *list)
+{
+	if(!list->borrowed)
+		free(list->base);
+	free(list);
+}
+
+inline anode_t* alist_node(alist_t *list, uint32_t index)
+{
+	return index == ALIST_NIL ? NULL : &list->base[index];
+}
+
+inline anode_t* alist_next(alist_t *list, anode_t *node)
+{
+	return alist_node(list, node->next);
+}
+
+inline anode_t* alist_car(alist_t *list)
+{
+	return alist_node(list, list->head);
+}
+
+// Double, but stop at the last capacity 32-bit indices can reach
+inline uint32_t alist_grown_capacity(uint32_t capacity)
+{
+	uint32_t limit = UINT32_MAX;
+	if(SIZE_MAX / sizeof(anode_t) < limit)
+		limit = (uint32_t) (SIZE_MAX / sizeof(anode_t));
+	return capacity > limit / 2 ? limit : capacity * 2;
+}
+
+// Amortized O(1), the arena doubles when it is full. ALIST_NIL if
+// every index is taken or the arena can't grow.
+inline uint32_t alist_new_node(alist_t *list, float val, uint32_t next)
+{
+	if(list->used == list->capacity)
+	{
+		uint32_t capacity = alist_grown_capacity(list->capacity);
+		if(capacity == list->capacity)
+			return ALIST_NIL;
+
+		anode_t *base;
+		if(list->borrowed)
+		{
+			base = (anode_t *) malloc(capacity * sizeof(anode_t));
+			if(base == NULL)
+				return ALIST_NIL;
+			memcpy(base, list->base, list->used * sizeof(anode_t));
+		}
+		else
+		{
+			base = (anode_t *) realloc(list->base, capacity * sizeof(anode_t));
+			if(base == NULL)
+				return ALIST_NIL;
+		}
+		list->base = base;
+		list->capacity = capacity;
+		list->borrowed = 0;
+	}
+	uint32_t index = list->used++;
+	list->base[index].value = val;
+	list->base[index].next = next;
+	return index;
+}
+
+// The pushes return 0 on success, -1 if the arena is full or out
+// of memory
+inline int alist_push_front(alist_t *list, float val)
+{
+	uint32_t index = alist_new_node(list, val, list->head);
+	if(index == ALIST_NIL)
+		return -1;
+	list->head = index;
+	if(list->tail == ALIST_NIL)
+		list->tail = list->head;
+	list->length++;
+	return 0;
+}
+
+inline int alist_push_back(alist_t *list, float val)
+{
+	uint32_t index = alist_new_node(list, val, ALIST_NIL);
+	if(index == ALIST_NIL)
+		return -1;
+	if(list->head == ALIST_NIL)
+		list->head = index;
+	else
+		list->base[list->tail].next = index;
+	list->tail = index;
+	list->length++;
+	return 0;
+}
+
+inline int alist_push_sorted(alist_t *list, float val)
+{
+	uint32_t before = ALIST_NIL;
+	uint32_t cur = list->head;
+
+	while(cur != ALIST_NIL && list->base[cur].value <= val)
+	{
+		before = cur;
+		cur = list->base[cur].next;
+	}
+
+	uint32_t index = alist_new_node(list, val, cur);
+	if(index == ALIST_NIL)
+		return -1;
+	if(before == ALIST_NIL)
+		list->head = index;
+	else
+		list->base[before].next = index;
+	if(cur == ALIST_NIL)
+		list->tail = index;
+	list->length++;
+	return 0;
+}
+
+inline size_t alist_length(alist_t *list)
+{
+	return list->length;
+}
+
+inline void alist_map_each(alist_t *list, void (*func)(anode_t*))
+{
+	anode_t *base = list->base;
+	for(uint32_t cur = list->head; cur != ALIST_NIL; cur = base[cur].next)
+		func(&base[cur]);
+}
+
+inline void double_anode(anode_t *n)
+{
+    n->value *= 2;
+}
+
+inline void print_anode(anode_t *n)
+{
+    printf("%f ", n->value);
+}
+
+inline void print_alist(alist_t *list)
+{
+	alist_map_each(list, print_anode);
+	printf("\n");
+}
+
+#endif
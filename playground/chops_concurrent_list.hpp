@@ -0,0 +1,160 @@
+#ifndef CHOPS_CONCURRENT_LIST_H
+#define CHOPS_CONCURRENT_LIST_H
+
+/*
+    This file contains a lock-free singly linked list that is used
+    as a stack shared between threads, also known as a Treiber stack.
+    push_front and pop_front are a load of the head, a relinking,
+    and a compare-and-swap of the head. If another thread changed
+    the head in the meantime, the CAS fails and we simply retry.
+    https://en.wikipedia.org/wiki/Treiber_stack
+
+    The classic problem with this is ABA: thread 1 reads head A and
+    its next B, thread 2 pops A and B and pushes A back, and thread 1
+    happily swaps head to B, which is no longer in the list. To
+    prevent that, the head is a tagged pointer: the upper bits of
+    the word hold a counter that is bumped on every successful CAS,
+    so a recycled A does not compare equal anymore.
+
+    Popped nodes are never given back to free(), another thread might
+    still be reading their next pointer. Instead they are pushed to a
+    second Treiber stack of spare nodes, which push_front reuses, and
+    everything is freed when the list is destroyed.
+*/
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <atomic>
+
+typedef struct cnode {
+    float value;
+    std::atomic<struct cnode *> next;
+}  cnode_t ;
+
+// A pointer and an ABA counter packed in one word. User space
+// pointers use at most 48 bits on 64-bit targets, on 32-bit ones
+// the pointer takes the lower half.
+typedef uint64_t tagged_ptr_t;
+
+#define CNODE_TAG_SHIFT (sizeof(void *) == 8 ? 48 : 32)
+#define CNODE_PTR_MASK ((((tagged_ptr_t) 1) << CNODE_TAG_SHIFT) - 1)
+
+typedef struct concurrent_list {
+    std::atomic<tagged_ptr_t> head;
+    std::atomic<tagged_ptr_t> spare;
+}  concurrent_list_t ;
+
+inline cnode_t* tagged_node(tagged_ptr_t t)
+{
+    return (cnode_t *) (uintptr_t) (t & CNODE_PTR_MASK);
+}
+
+inline tagged_ptr_t make_tagged(cnode_t *node, tagged_ptr_t old)
+{
+    tagged_ptr_t tag = (old >> CNODE_TAG_SHIFT) + 1;
+    return (tag << CNODE_TAG_SHIFT) | (tagged_ptr_t) (uintptr_t) node;
+}
+
+inline concurrent_list_t* make_concurrent_list()
+{
+    concurrent_list_t *list = new concurrent_list_t;
+    list->head.store(0);
+    list->spare.store(0);
+    return list;
+}
+
+// Not thread safe, every other thread must be done with the list
+inline void destroy_concurrent_list(concurrent_list_t *list)
+{
+    cnode_t *stacks[2] = { tagged_node(list->head.load()),
+                           tagged_node(list->spare.load()) };
+    for(cnode_t *cur : stacks)
+    {
+        while(cur != NULL)
+        {
+            cnode_t *following = cur->next.load(std::memory_order_relaxed);
+            delete cur;
+            cur = following;
+        }
+    }
+    delete list;
+}
+
+// Pushes the chain first..last, already linked through next, with one CAS
+inline void tagged_push_chain(std::atomic<tagged_ptr_t> &top, cnode_t *first, cnode_t *last)
+{
+    tagged_ptr_t old = top.load(std::memory_order_relaxed);
+    do
+    {
+        last->next.store(tagged_node(old), std::memory_order_relaxed);
+    }while(!top.compare_exchange_weak(old, make_tagged(first, old),
+                                      std::memory_order_release,
+                                      std::memory_order_relaxed));
+}
+
+inline void tagged_push(std::atomic<tagged_ptr_t> &top, cnode_t *node)
+{
+    tagged_push_chain(top, node, node);
+}
+
+inline cnode_t* tagged_pop(std::atomic<tagged_ptr_t> &top)
+{
+    tagged_ptr_t old = top.load(std::memory_order_acquire);
+    cnode_t *node;
+    do
+    {
+        node = tagged_node(old);
+        if(node == NULL)
+            return NULL;
+        // node may already be popped by someone else, but since nodes
+        // are never freed this read is safe, and the tag makes the
+        // CAS fail if that happened
+    }while(!top.compare_exchange_weak(old,
+                                      make_tagged(node->next.load(std::memory_order_relaxed), old),
+                                      std::memory_order_acquire,
+                                      std::memory_order_acquire));
+    return node;
+}
+
+// A single attempt at tagged_pop, NULL if the stack is empty or
+// another thread changed it first. Wait-free, for callers that
+// have somewhere else to go.
+inline cnode_t* tagged_try_pop(std::atomic<tagged_ptr_t> &top)
+{
+    tagged_ptr_t old = top.load(std::memory_order_acquire);
+    cnode_t *node = tagged_node(old);
+    if(node == NULL)
+        return NULL;
+    // strong, a spurious failure would cost an allocation
+    if(!top.compare_exchange_strong(old,
+                                    make_tagged(node->next.load(std::memory_order_relaxed), old),
+                                    std::memory_order_acquire,
+                                    std::memory_order_relaxed))
+        return NULL;
+    return node;
+}
+
+// Lock-free O(1) push front
+inline void concurrent_push_front(concurrent_list_t *list, float val)
+{
+    cnode_t *node = tagged_pop(list->spare);
+    if(node == NULL)
+        node = new cnode_t;
+
+    node->value = val;
+    tagged_push(list->head, node);
+}
+
+// Lock-free O(1) pop front, returns 0 if the list was empty
+inline int concurrent_pop_front(concurrent_list_t *list, float *val)
+{
+    cnode_t *node = tagged_pop(list->head);
+    if(node == NULL)
+        return 0;
+
+    *val = node->value;
+    tagged_push(list->spare, node);
+    return 1;
+}
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef CHOPS_CONS_LIST_H
+#define CHOPS_CONS_LIST_H
+
+/*
+    This file contains a C-style persistent (immutable) singly
+    linked list, the cons list of functional languages. A list is
+    just a pointer to its first cell and NULL is the empty list.
+    Cells are never modified after they are created, so any number
+    of lists can share the same tail: consing a value in front of
+    a list is O(1) and leaves the old list untouched.
+
+    chops_singlylist shares structure in car/cdr too, but nobody
+    owns the shared tail there. Here each cell carries a reference
+    count. A cell holds one reference to its tail, and every pointer
+    the user keeps holds one as well. Releasing the last reference
+    to a cell frees it and releases its tail in turn, so a shared
+    tail is freed exactly once, when the last list using it goes.
+    https://www.wikiwand.com/en/Persistent_data_structure#/Linked_lists
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+
+typedef struct cons {
+    float value;
+    unsigned refs;
+    struct cons *next;
+}  cons_t ;
+
+inline cons_t* cons_retain(cons_t *list)
+{
+	if(list != NULL)
+		list->refs++;
+	return list;
+}
+
+// Iterative, a long list would blow the stack if we recursed
+inline void cons_release(cons_t *list)
+{
+	while(list != NULL && --list->refs == 0)
+	{
+		cons_t *following = list->next;
+		free(list);
+		list = following;
+	}
+}
+
+// O(1), the new cell retains tail and the caller owns the result
+inline cons_t* cons(float val, cons_t *tail)
+{
+	cons_t *cell = (cons_t *) malloc(sizeof(cons_t));
+
+	cell->value = val;
+	cell->refs = 1;
+	cell->next = cons_retain(tail);
+	return cell;
+}
+
+inline float cons_car(const cons_t *list)
+{
+	return list->value;
+}
+
+// O(1) and allocation free. The tail is borrowed from list, so
+// retain it if it has to outlive list.
+inline cons_t* cons_cdr(const cons_t *list)
+{
+	return list->next;
+}
+
+inline size_t cons_length(const cons_t *list)
+{
+	size_t length = 0;
+	for(; list != NULL; list = list->next)
+		length++;
+	return length;
+}
+
+inline void cons_map_each(const cons_t *list, void (*func)(float))
+{
+	for(; list != NULL; list = list->next)
+		func(list->value);
+}
+
+inline void print_cons_value(float v)
+{
+    printf("%f ", v);
+}
+
+inline void print_cons(const cons_t *list)
+{
+	cons_map_each(list, print_cons_value);
+	printf("\n");
+}
+
+#endif
@@ -0,0 +1,170 @@
+#ifndef CHOPS_LIST_EXPORT_H
+#define CHOPS_LIST_EXPORT_H
+
+/*
+    This file contains a buffered export path for list_t. print_list
+    calls printf once per node, which parses the format string and
+    takes the stdio lock every time, and %f prints six decimals
+    whether they are needed or not.
+
+    Here values are formatted with std::to_chars, which gives the
+    shortest text that reads back to the same float, straight into
+    a big buffer. The buffer only goes out when it is full, with a
+    single fwrite to a FILE* or write to a file descriptor. The
+    binary format skips formatting altogether and writes the raw
+    floats in host byte order.
+
+    A list_exporter_t owns the buffer, so repeated exports can
+    reuse it instead of allocating every time.
+*/
+
+#include <charconv>
+#include <errno.h>
+#include <string.h>
+#include <playground/chops_singlylist.hpp>
+
+#ifdef _WIN32
+#include <io.h>
+#define chops_write _write
+#else
+#include <unistd.h>
+#define chops_write write
+#endif
+
+#define EXPORT_DEFAULT_BUFFER (1 << 16)
+
+// the longest shortest-roundtrip float, "-1.17549435e-38", plus a separator
+#define EXPORT_MAX_FLOAT_CHARS 32
+
+typedef enum export_format {
+    EXPORT_TEXT,    // space separated, newline at the end, like print_list
+    EXPORT_BINARY   // raw floats, host byte order
+}  export_format_t ;
+
+typedef struct list_exporter {
+    char *buf;
+    size_t size;
+    size_t used;
+    FILE *file;     // exactly one of file and fd is used
+    int fd;
+    int failed;
+}  list_exporter_t ;
+
+inline list_exporter_t* make_list_exporter(size_t buffer_size)
+{
+	list_exporter_t *exporter = (list_exporter_t *) calloc(1, sizeof(list_exporter_t));
+	if(buffer_size < EXPORT_MAX_FLOAT_CHARS)
+		buffer_size = EXPORT_MAX_FLOAT_CHARS;
+	exporter->buf = (char *) malloc(buffer_size);
+	exporter->size = buffer_size;
+	exporter->fd = -1;
+	return exporter;
+}
+
+inline void destroy_list_exporter(list_exporter_t *exporter)
+{
+	free(exporter->buf);
+	free(exporter);
+}
+
+inline void exporter_flush(list_exporter_t *exporter)
+{
+	if(exporter->used == 0 || exporter->failed)
+	{
+		exporter->used = 0;
+		return;
+	}
+
+	if(exporter->file != NULL)
+	{
+		if(fwrite(exporter->buf, 1, exporter->used, exporter->file) != exporter->used)
+			exporter->failed = 1;
+	}
+	else
+	{
+		// write may take less than we give it, or be interrupted
+		const char *p = exporter->buf;
+		size_t left = exporter->used;
+		while(left > 0)
+		{
+			long n = (long) chops_write(exporter->fd, p, (unsigned) left);
+			if(n < 0 && errno == EINTR)
+				continue;
+			if(n <= 0)
+			{
+				exporter->failed = 1;
+				break;
+			}
+			p += n;
+			left -= (size_t) n;
+		}
+	}
+	exporter->used = 0;
+}
+
+inline void exporter_reserve(list_exporter_t *exporter, size_t bytes)
+{
+	if(exporter->size - exporter->used < bytes)
+		exporter_flush(exporter);
+}
+
+inline int export_to_sink(list_exporter_t *exporter, list_t *list, export_format_t format)
+{
+	exporter->used = 0;
+	exporter->failed = 0;
+
+	for(node_t *cur = list->head; cur != NULL && !exporter->failed; cur = cur->next)
+	{
+		if(format == EXPORT_BINARY)
+		{
+			exporter_reserve(exporter, sizeof(float));
+			memcpy(exporter->buf + exporter->used, &cur->value, sizeof(float));
+			exporter->used += sizeof(float);
+		}
+		else
+		{
+			exporter_reserve(exporter, EXPORT_MAX_FLOAT_CHARS);
+			char *first = exporter->buf + exporter->used;
+			char *last = exporter->buf + exporter->size;
+			if(cur != list->head)
+				*first++ = ' ';
+			first = std::to_chars(first, last, cur->value).ptr;
+			exporter->used = first - exporter->buf;
+		}
+	}
+	if(format == EXPORT_TEXT)
+	{
+		exporter_reserve(exporter, 1);
+		exporter->buf[exporter->used++] = '\n';
+	}
+	exporter_flush(exporter);
+	return exporter->failed ? -1 : 0;
+}
+
+// Returns 0 on success, -1 if a write failed
+inline int export_list(list_exporter_t *exporter, list_t *list, FILE *file,
+                       export_format_t format)
+{
+	exporter->file = file;
+	exporter->fd = -1;
+	return export_to_sink(exporter, list, format);
+}
+
+inline int export_list_fd(list_exporter_t *exporter, list_t *list, int fd,
+                          export_format_t format)
+{
+	exporter->file = NULL;
+	exporter->fd = fd;
+	return export_to_sink(exporter, list, format);
+}
+
+// print_list, but buffered, with a one-off exporter
+inline int print_list_buffered(list_t *list)
+{
+	list_exporter_t *exporter = make_list_exporter(EXPORT_DEFAULT_BUFFER);
+	int result = export_list(exporter, list, stdout, EXPORT_TEXT);
+	destroy_list_exporter(exporter);
+	return result;
+}
+
+#endif
@@ -0,0 +1,262 @@
+#ifndef CHOPS_LIST_MMAP_H
+#define CHOPS_LIST_MMAP_H
+
+/*
+    This file contains a file format for float lists that can be
+    used without loading it. Rebuilding a saved list_t with
+    push_back costs a malloc and a cache miss per node. Here the
+    file is an alist_t arena, from chops_arena_list, after a small
+    header. Links in an arena are 32-bit indices relative to its
+    base, not addresses, so they mean the same thing wherever the
+    file ends up in memory. list_map maps the file and hands back
+    an alist_t that points into the mapping, which alist_map_each
+    and the other alist functions traverse directly. Only the
+    pages that are touched are ever read from disk.
+
+    The mapping is private, so the list can be modified in place
+    and the kernel copies a page the first time it is written, the
+    file itself never changes. The arena is borrowed from the
+    mapping, and pushing past its end moves it to the heap first.
+    To keep changes, save the list again with alist_save.
+
+    list_save writes a list_t in traversal order, so node i links
+    to node i + 1 and a mapped traversal reads the file front to
+    back. alist_save writes an arena as it is.
+
+    Values and links are stored in host byte order, a file made on
+    a machine of the other endianness is refused. POSIX only.
+*/
+
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <playground/chops_arena_list.hpp>
+#include <playground/chops_singlylist.hpp>
+
+#define LIST_FILE_MAGIC "CHOPSLST"
+#define LIST_FILE_VERSION 1
+#define LIST_FILE_BYTE_ORDER 0x01020304u
+
+// Nodes written per fwrite by list_save
+#define LIST_SAVE_CHUNK 4096
+
+typedef struct list_file_header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint32_t node_size;     // sizeof(anode_t) of the writer
+    uint32_t used;          // slots that follow, slot 0 is the NIL
+    uint32_t head;
+    uint32_t tail;
+    uint64_t length;
+}  list_file_header_t ;
+
+typedef struct mapped_list {
+    void *map;
+    size_t size;
+    alist_t *list;
+}  mapped_list_t ;
+
+inline list_file_header_t make_list_file_header(uint32_t used, uint32_t head,
+                                                uint32_t tail, uint64_t length)
+{
+	list_file_header_t header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, LIST_FILE_MAGIC, sizeof(header.magic));
+	header.version = LIST_FILE_VERSION;
+	header.byte_order = LIST_FILE_BYTE_ORDER;
+	header.node_size = sizeof(anode_t);
+	header.used = used;
+	header.head = head;
+	header.tail = tail;
+	header.length = length;
+	return header;
+}
+
+// Returns 0 on success, -1 on failure
+inline int alist_save(alist_t *list, const char *path)
+{
+	FILE *file = fopen(path, "wb");
+	if(file == NULL)
+		return -1;
+
+	list_file_header_t header = make_list_file_header(list->used, list->head,
+	                                                  list->tail, list->length);
+	int failed = fwrite(&header, sizeof(header), 1, file) != 1 ||
+	             fwrite(list->base, sizeof(anode_t), list->used, file) != list->used;
+	if(fclose(file) != 0)
+		failed = 1;
+	return failed ? -1 : 0;
+}
+
+// Returns 0 on success, -1 on failure or if the list has more
+// nodes than 32-bit links can reach
+inline int list_save(list_t *list, const char *path)
+{
+	if(list->length >= UINT32_MAX)
+		return -1;
+	FILE *file = fopen(path, "wb");
+	if(file == NULL)
+		return -1;
+
+	uint32_t count = (uint32_t) list->length;
+	list_file_header_t header = make_list_file_header(count + 1,
+	                                                  count ? 1 : ALIST_NIL,
+	                                                  count, count);
+	int failed = fwrite(&header, sizeof(header), 1, file) != 1;
+
+	anode_t chunk[LIST_SAVE_CHUNK];
+	size_t used = 1;
+	uint32_t index = 1;
+	memset(&chunk[0], 0, sizeof(anode_t));
+
+	for(node_t *cur = list->head; cur != NULL && !failed; cur = cur->next, index++)
+	{
+		chunk[used].value = cur->value;
+		chunk[used].next = index < count ? index + 1 : ALIST_NIL;
+		if(++used == LIST_SAVE_CHUNK)
+		{
+			failed = fwrite(chunk, sizeof(anode_t), used, file) != used;
+			used = 0;
+		}
+	}
+	if(!failed && used > 0)
+		failed = fwrite(chunk, sizeof(anode_t), used, file) != used;
+	if(fclose(file) != 0)
+		failed = 1;
+	return failed ? -1 : 0;
+}
+
+// Checks everything in the header, so a short or foreign file is
+// refused here instead of crashing later. The links between nodes
+// are checked by alist_links_valid.
+inline int list_file_valid(const list_file_header_t *header, size_t size)
+{
+	return size >= sizeof(list_file_header_t) &&
+	       memcmp(header->magic, LIST_FILE_MAGIC, sizeof(header->magic)) == 0 &&
+	       header->version == LIST_FILE_VERSION &&
+	       header->byte_order == LIST_FILE_BYTE_ORDER &&
+	       header->node_size == sizeof(anode_t) &&
+	       header->used >= 1 &&
+	       (size - sizeof(list_file_header_t)) / sizeof(anode_t) >= header->used &&
+	       header->head < header->used && header->tail < header->used &&
+	       header->length < header->used;
+}
+
+// O(n), walks the list and checks that every link stays inside the
+// arena and that the walk ends at tail after exactly length nodes
+inline int alist_links_valid(alist_t *list)
+{
+	uint32_t last = ALIST_NIL;
+	uint32_t cur = list->head;
+	size_t count = 0;
+	while(cur != ALIST_NIL)
+	{
+		if(cur >= list->used || count == list->length)
+			return 0;
+		last = cur;
+		cur = list->base[cur].next;
+		count++;
+	}
+	return count == list->length && last == list->tail;
+}
+
+// O(1), NULL if the file can't be opened or is not a list file.
+// Checking the links would read the whole file, so it is left to
+// the caller: the alist functions follow them as they are, call
+// alist_links_valid first on files that may be corrupt.
+inline mapped_list_t* list_map(const char *path)
+{
+	int fd = open(path, O_RDONLY);
+	if(fd < 0)
+		return NULL;
+
+	struct stat st;
+	if(fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(list_file_header_t))
+	{
+		close(fd);
+		return NULL;
+	}
+	size_t size = (size_t) st.st_size;
+	// writable but private, writes stay in our copy of the page
+	void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(map == MAP_FAILED)
+		return NULL;
+
+	list_file_header_t *header = (list_file_header_t *) map;
+	if(!list_file_valid(header, size))
+	{
+		munmap(map, size);
+		return NULL;
+	}
+
+	mapped_list_t *mapped = (mapped_list_t *) calloc(1, sizeof(mapped_list_t));
+	mapped->map = map;
+	mapped->size = size;
+	mapped->list = (alist_t *) calloc(1, sizeof(alist_t));
+	mapped->list->base = (anode_t *) (header + 1);
+	mapped->list->capacity = header->used;
+	mapped->list->used = header->used;
+	mapped->list->head = header->head;
+	mapped->list->tail = header->tail;
+	mapped->list->length = (size_t) header->length;
+	mapped->list->borrowed = 1;
+	return mapped;
+}
+
+inline void list_unmap(mapped_list_t *mapped)
+{
+	// frees the arena too if it moved to the heap
+	destroy_alist(mapped->list);
+	munmap(mapped->map, mapped->size);
+	free(mapped);
+}
+
+// For code that wants a list_t after all, the values go into a
+// single block. NULL on the same failures as list_map, if the links
+// are broken in any way alist_links_valid would notice, or if there
+// is not enough memory.
+inline list_t* list_load(const char *path)
+{
+	mapped_list_t *mapped = list_map(path);
+	if(mapped == NULL)
+		return NULL;
+
+	// length < used, so this can't overflow
+	alist_t *arena = mapped->list;
+	float *values = (float *) malloc((arena->length + 1) * sizeof(float));
+	if(values == NULL)
+	{
+		list_unmap(mapped);
+		return NULL;
+	}
+
+	// the checks of alist_links_valid, done while copying so the
+	// file is read once
+	uint32_t last = ALIST_NIL;
+	uint32_t cur = arena->head;
+	size_t count = 0;
+	int valid = 1;
+	while(cur != ALIST_NIL)
+	{
+		if(cur >= arena->used || count == arena->length)
+		{
+			valid = 0;
+			break;
+		}
+		values[count++] = arena->base[cur].value;
+		last = cur;
+		cur = arena->base[cur].next;
+	}
+	valid = valid && count == arena->length && last == arena->tail;
+
+	list_t *list = valid ? list_from_array(values, count) : NULL;
+	free(values);
+	list_unmap(mapped);
+	return list;
+}
+
+#endif
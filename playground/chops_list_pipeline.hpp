@@ -0,0 +1,191 @@
+#ifndef CHOPS_LIST_PIPELINE_H
+#define CHOPS_LIST_PIPELINE_H
+
+/*
+	This file contains lazy, fused map/filter/reduce pipelines over
+	list_t. Running map_each three times chases every next pointer
+	three times and makes three indirect calls per node. Here
+
+		float sum = chops::from(list)
+			.map([](float v) { return v * 2; })
+			.filter([](float v) { return v > 10; })
+			.reduce(0.0f, std::plus<float>());
+
+	map and filter only build a type describing the pipeline, no
+	list is touched until a terminal operation (reduce, for_each,
+	collect) runs. Then the list is walked once and every value is
+	pushed through all the stages. Stages are template parameters,
+	not function pointers, so the compiler sees the whole pipeline
+	and can inline it into a single loop.
+
+	Chaining is shared through CRTP, every stage derives from
+	pipeline<Stage> and only has to say how it runs a sink.
+
+	C code cannot use templates, so there is also a runtime version
+	at the bottom, a list of stage_t descriptors run by a single
+	loop. It still does one pass, but calls through pointers.
+*/
+
+#include <utility>
+#include <playground/chops_singlylist.hpp>
+
+namespace chops {
+
+template <typename Upstream, typename F>
+struct map_stage;
+
+template <typename Upstream, typename P>
+struct filter_stage;
+
+template <typename Derived>
+struct pipeline
+{
+	const Derived& self() const { return *static_cast<const Derived*>(this); }
+
+	template <typename F>
+	map_stage<Derived, F> map(F f) const
+	{
+		return map_stage<Derived, F>(self(), std::move(f));
+	}
+
+	template <typename P>
+	filter_stage<Derived, P> filter(P pred) const
+	{
+		return filter_stage<Derived, P>(self(), std::move(pred));
+	}
+
+	template <typename T, typename Op>
+	T reduce(T init, Op op) const
+	{
+		self().run([&](auto v) { init = op(init, v); });
+		return init;
+	}
+
+	template <typename F>
+	void for_each(F f) const
+	{
+		self().run(f);
+	}
+
+	size_t count() const
+	{
+		size_t n = 0;
+		self().run([&](auto) { n++; });
+		return n;
+	}
+
+	// Materializes the pipeline into a new list
+	list_t* collect() const
+	{
+		list_t *out = make_list();
+		self().run([&](float v) { push_back(out, v); });
+		return out;
+	}
+};
+
+// Source stage, feeds the values of a list in order
+struct list_source : pipeline<list_source>
+{
+	list_t *list;
+
+	explicit list_source(list_t *l) : list(l) {}
+
+	template <typename Sink>
+	void run(Sink &&sink) const
+	{
+		for(node_t *cur = list->head; cur != NULL; cur = cur->next)
+			sink(cur->value);
+	}
+};
+
+template <typename Upstream, typename F>
+struct map_stage : pipeline<map_stage<Upstream, F>>
+{
+	Upstream up;
+	F f;
+
+	map_stage(Upstream u, F fn) : up(std::move(u)), f(std::move(fn)) {}
+
+	template <typename Sink>
+	void run(Sink &&sink) const
+	{
+		up.run([&](auto v) { sink(f(v)); });
+	}
+};
+
+template <typename Upstream, typename P>
+struct filter_stage : pipeline<filter_stage<Upstream, P>>
+{
+	Upstream up;
+	P pred;
+
+	filter_stage(Upstream u, P p) : up(std::move(u)), pred(std::move(p)) {}
+
+	template <typename Sink>
+	void run(Sink &&sink) const
+	{
+		up.run([&](auto v) { if(pred(v)) sink(v); });
+	}
+};
+
+inline list_source from(list_t *list)
+{
+	return list_source(list);
+}
+
+// namespace chops ends
+}
+
+// C-compatible runtime pipelines
+
+typedef enum stage_kind {
+    STAGE_MAP,
+    STAGE_FILTER
+}  stage_kind_t ;
+
+typedef struct stage {
+    stage_kind_t kind;
+    float (*map)(float);        // used by STAGE_MAP
+    int (*filter)(float);       // used by STAGE_FILTER, keep if non-zero
+}  stage_t ;
+
+// Pushes val through the stages, returns 0 if a filter dropped it
+inline int run_stages(const stage_t *stages, size_t count, float *val)
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		if(stages[i].kind == STAGE_MAP)
+			*val = stages[i].map(*val);
+		else if(!stages[i].filter(*val))
+			return 0;
+	}
+	return 1;
+}
+
+// One pass over list, folding every value that makes it through
+inline float list_pipeline_reduce(list_t *list, const stage_t *stages, size_t count,
+                                  float (*reduce)(float, float), float init)
+{
+	for(node_t *cur = list->head; cur != NULL; cur = cur->next)
+	{
+		float val = cur->value;
+		if(run_stages(stages, count, &val))
+			init = reduce(init, val);
+	}
+	return init;
+}
+
+// One pass over list, the surviving values go to a new list
+inline list_t* list_pipeline_collect(list_t *list, const stage_t *stages, size_t count)
+{
+	list_t *out = make_list();
+	for(node_t *cur = list->head; cur != NULL; cur = cur->next)
+	{
+		float val = cur->value;
+		if(run_stages(stages, count, &val))
+			push_back(out, val);
+	}
+	return out;
+}
+
+#endif
@@ -0,0 +1,99 @@
+#ifndef CHOPS_LIST_PREFETCH_H
+#define CHOPS_LIST_PREFETCH_H
+
+/*
+    This file contains traversals of list_t that prefetch ahead.
+    A plain traversal is a chain of dependent loads: the address
+    of the next node is only known once the current one arrived,
+    so on a list bigger than the last level cache every step costs
+    a full trip to memory and the CPU can't overlap them.
+
+    map_each_prefetch and destroy_list_prefetch ask for next->next
+    while we work on the current node. That only hides one node's
+    worth of work, so it helps when func is not trivial.
+
+    To really overlap misses we need addresses that do not depend
+    on each other. A jump_index_t remembers every node of the list
+    in an array (jump pointers), so map_each_jump can prefetch the
+    node PREFETCH_DISTANCE steps ahead and keep many misses in
+    flight. The index costs a pointer per node and is only valid
+    until the list is modified, so it pays off for lists that are
+    traversed many times.
+*/
+
+#include <playground/chops_prefetch.hpp>
+#include <playground/chops_singlylist.hpp>
+
+// About how many misses a core can have in flight
+#define PREFETCH_DISTANCE 16
+
+inline void map_each_prefetch(list_t *list, void (*func)(node_t*))
+{
+	node_t *cur = list->head;
+	while(cur != NULL)
+	{
+		node_t *following = cur->next;
+		if(following != NULL)
+			CHOPS_PREFETCH(following->next);
+		func(cur);
+		cur = following;
+	}
+}
+
+inline void destroy_list_prefetch(list_t *list)
+{
+	// nodes in blocks are freed with their block
+	if(list->head != NULL && list->block_nodes != list->length)
+	{
+		size_t count;
+		block_range_t *ranges = make_block_ranges(list, &count);
+		node_t *cur = list->head;
+		while(cur != NULL)
+		{
+			node_t *following = cur->next;
+			if(following != NULL)
+				CHOPS_PREFETCH(following->next);
+			if(find_block_range(ranges, count, cur) == NULL)
+				free(cur);
+			cur = following;
+		}
+		free(ranges);
+	}
+	free_blocks(list);
+	free(list);
+}
+
+typedef struct jump_index {
+    node_t **nodes;
+    size_t count;
+}  jump_index_t ;
+
+// One pass over list
+inline jump_index_t* make_jump_index(list_t *list)
+{
+	jump_index_t *index = (jump_index_t *) calloc(1, sizeof(jump_index_t));
+	index->nodes = (node_t **) malloc(list->length * sizeof(node_t *));
+	for(node_t *cur = list->head; cur != NULL; cur = cur->next)
+		index->nodes[index->count++] = cur;
+	return index;
+}
+
+inline void destroy_jump_index(jump_index_t *index)
+{
+	free(index->nodes);
+	free(index);
+}
+
+inline void map_each_jump(jump_index_t *index, void (*func)(node_t*))
+{
+	size_t i = 0;
+	for(; i + PREFETCH_DISTANCE < index->count; i++)
+	{
+		CHOPS_PREFETCH(index->nodes[i + PREFETCH_DISTANCE]);
+		func(index->nodes[i]);
+	}
+	for(; i < index->count; i++)
+		func(index->nodes[i]);
+}
+
+#endif
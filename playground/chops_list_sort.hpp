@@ -0,0 +1,312 @@
+#ifndef CHOPS_LIST_SORT_H
+#define CHOPS_LIST_SORT_H
+
+/*
+    This file contains a stable merge sort for list_t that works
+    by relinking nodes, so it needs no allocation and values are
+    never copied. It is bottom-up: nodes are taken off the list one
+    by one and pushed into bins, where bin k holds a sorted run of
+    2^k nodes. Whenever two runs of the same size meet they are
+    merged and carried to the next bin, like incrementing a binary
+    counter. 64 bins are enough for any list that fits in memory,
+    and the whole thing is O(n log n) with O(1) extra space.
+    This is the scheme SGI's std::list::sort uses.
+
+    list_sort_parallel cuts the list into one segment per thread,
+    sorts the segments concurrently with the same algorithm, and
+    then merges neighbouring segments pairwise, again in parallel,
+    until a single run is left.
+
+    list_merge_k merges k lists that are already sorted, such as
+    ones built with push_sorted, into the first of them. It plays
+    a tournament between the list heads in a loser tree, so each
+    node costs about log k comparisons and is touched only once.
+    The tree lives on the stack, for more than LIST_MERGE_K_TREE
+    lists the merge happens in rounds of that many at a time.
+    list_merge_k_parallel gives every thread a share of the lists
+    and then merges the results pairwise like list_sort_parallel.
+*/
+
+#include <thread>
+#include <utility>
+#include <vector>
+#include <playground/chops_singlylist.hpp>
+
+#define LIST_SORT_BINS 64
+
+// Stable merge of two sorted runs, on ties nodes of a come first.
+// Returns the head and stores the last node in *tail.
+inline node_t* merge_runs(node_t *a, node_t *b, node_t **tail)
+{
+	node_t head;
+	node_t *last = &head;
+
+	while(a != NULL && b != NULL)
+	{
+		if(b->value < a->value)
+		{
+			last->next = b;
+			b = b->next;
+		}
+		else
+		{
+			last->next = a;
+			a = a->next;
+		}
+		last = last->next;
+	}
+	last->next = a != NULL ? a : b;
+	if(tail != NULL)
+	{
+		while(last->next != NULL)
+			last = last->next;
+		*tail = last;
+	}
+	return head.next;
+}
+
+// Sorts the NULL terminated run starting at first, returns the
+// new head and stores the new last node in *tail
+inline node_t* sort_run(node_t *first, node_t **tail)
+{
+	node_t *bins[LIST_SORT_BINS] = { NULL };
+	int filled = 0;
+
+	while(first != NULL)
+	{
+		node_t *carry = first;
+		first = first->next;
+		carry->next = NULL;
+
+		int i = 0;
+		for(; bins[i] != NULL; i++)
+		{
+			// bins hold older nodes, so they go first for stability
+			carry = merge_runs(bins[i], carry, NULL);
+			bins[i] = NULL;
+		}
+		bins[i] = carry;
+		if(i >= filled)
+			filled = i + 1;
+	}
+
+	node_t *result = NULL;
+	*tail = NULL;
+	for(int i = 0; i < filled; i++)
+		if(bins[i] != NULL)
+			result = merge_runs(bins[i], result, tail);
+	return result;
+}
+
+// O(n log n), stable, in place
+inline void list_sort(list_t *list)
+{
+	if(list->head == NULL)
+		return;
+	list->head = sort_run(list->head, &list->tail);
+}
+
+// threads == 0 uses every hardware thread
+inline void list_sort_parallel(list_t *list, unsigned threads)
+{
+	if(threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if(threads <= 1 || list->length < 2 * (size_t) threads)
+	{
+		list_sort(list);
+		return;
+	}
+
+	// cut the list into equal segments
+	std::vector<node_t *> heads(threads), tails(threads);
+	node_t *cur = list->head;
+	for(unsigned t = 0; t < threads; t++)
+	{
+		size_t count = list->length / threads + (t < list->length % threads ? 1 : 0);
+		heads[t] = cur;
+		for(size_t i = 1; i < count; i++)
+			cur = cur->next;
+		node_t *following = cur->next;
+		cur->next = NULL;
+		cur = following;
+	}
+
+	std::vector<std::thread> workers;
+	for(unsigned t = 0; t < threads; t++)
+		workers.emplace_back([&heads, &tails, t] {
+			heads[t] = sort_run(heads[t], &tails[t]);
+		});
+	for(auto &w : workers)
+		w.join();
+
+	// merge neighbours pairwise, segment t absorbs segment t + step
+	for(unsigned step = 1; step < threads; step *= 2)
+	{
+		workers.clear();
+		for(unsigned t = 0; t + step < threads; t += 2 * step)
+			workers.emplace_back([&heads, &tails, t, step] {
+				heads[t] = merge_runs(heads[t], heads[t + step], &tails[t]);
+			});
+		for(auto &w : workers)
+			w.join();
+	}
+
+	list->head = heads[0];
+	list->tail = tails[0];
+}
+
+// Lists merged by one loser tree, a node_t* and a size_t each on the stack
+#define LIST_MERGE_K_TREE 256
+
+// Merges two sorted lists into dst in O(length), src is left empty.
+// Stable, on ties nodes of dst come first.
+inline void list_merge(list_t *dst, list_t *src)
+{
+	if(src->head != NULL)
+	{
+		if(dst->head == NULL)
+		{
+			dst->head = src->head;
+			dst->tail = src->tail;
+		}
+		else
+		{
+			// the overall last node is known without walking
+			node_t *tail = src->tail->value < dst->tail->value ? dst->tail : src->tail;
+			dst->head = merge_runs(dst->head, src->head, NULL);
+			dst->tail = tail;
+		}
+		dst->length += src->length;
+	}
+	src->head = NULL;
+	src->tail = NULL;
+	src->length = 0;
+	move_blocks(dst, src);
+}
+
+// Loser tree over leaves 0..k-1 at positions k..2k-1, heads[i] is the
+// current node of leaf i and NULL counts as bigger than anything.
+// Ties go to the lower leaf, which keeps the merge stable.
+inline int tree_beats(node_t **heads, size_t a, size_t b)
+{
+	if(heads[b] == NULL)
+		return 1;
+	if(heads[a] == NULL)
+		return 0;
+	if(heads[a]->value < heads[b]->value)
+		return 1;
+	return !(heads[b]->value < heads[a]->value) && a < b;
+}
+
+// Plays the matches below position n, returns the winning leaf
+inline size_t tree_build(node_t **heads, size_t *losers, size_t k, size_t n)
+{
+	if(n >= k)
+		return n - k;
+	size_t left = tree_build(heads, losers, k, 2 * n);
+	size_t right = tree_build(heads, losers, k, 2 * n + 1);
+	if(tree_beats(heads, left, right))
+	{
+		losers[n] = right;
+		return left;
+	}
+	losers[n] = left;
+	return right;
+}
+
+// Merges lists[0], lists[stride], ... count of them, into lists[0]
+inline void merge_group(list_t **lists, size_t count, size_t stride)
+{
+	node_t *heads[LIST_MERGE_K_TREE] = {};
+	size_t losers[LIST_MERGE_K_TREE] = {};
+	list_t *dst = lists[0];
+
+	for(size_t i = 0; i < count; i++)
+		heads[i] = lists[i * stride]->head;
+
+	size_t winner = tree_build(heads, losers, count, 1);
+	node_t head;
+	node_t *last = &head;
+	head.next = NULL;
+
+	while(heads[winner] != NULL)
+	{
+		last->next = heads[winner];
+		last = heads[winner];
+		heads[winner] = last->next;
+		// replay the winner's path, it meets the losers it beat before
+		for(size_t n = (winner + count) / 2; n >= 1; n /= 2)
+			if(tree_beats(heads, losers[n], winner))
+				std::swap(losers[n], winner);
+	}
+
+	for(size_t i = 1; i < count; i++)
+	{
+		list_t *src = lists[i * stride];
+		dst->length += src->length;
+		src->head = NULL;
+		src->tail = NULL;
+		src->length = 0;
+		move_blocks(dst, src);
+	}
+	dst->head = head.next;
+	dst->tail = last != &head ? last : NULL;
+}
+
+// O(n log k), stable, no allocation. Every list must be sorted, the
+// result is lists[0] and the others are left empty.
+inline void list_merge_k(list_t **lists, size_t k)
+{
+	// each round merges groups of LIST_MERGE_K_TREE lists into the
+	// first of the group, the next round merges those firsts
+	for(size_t stride = 1; stride < k; stride *= LIST_MERGE_K_TREE)
+		for(size_t first = 0; first < k; first += stride * LIST_MERGE_K_TREE)
+		{
+			size_t count = (k - first + stride - 1) / stride;
+			if(count > LIST_MERGE_K_TREE)
+				count = LIST_MERGE_K_TREE;
+			if(count > 1)
+				merge_group(lists + first, count, stride);
+		}
+}
+
+// Same result as list_merge_k. threads == 0 uses every hardware thread.
+inline void list_merge_k_parallel(list_t **lists, size_t k, unsigned threads)
+{
+	if(threads == 0)
+		threads = std::thread::hardware_concurrency();
+	if(threads > k / 2)
+		threads = (unsigned) (k / 2);
+	if(threads <= 1)
+	{
+		list_merge_k(lists, k);
+		return;
+	}
+
+	// thread t merges a run of neighbouring lists into its first one
+	std::vector<size_t> firsts(threads);
+	std::vector<std::thread> workers;
+	for(unsigned t = 0; t < threads; t++)
+	{
+		firsts[t] = k / threads * t + (t < k % threads ? t : k % threads);
+		size_t count = k / threads + (t < k % threads ? 1 : 0);
+		workers.emplace_back([lists, first = firsts[t], count] {
+			list_merge_k(lists + first, count);
+		});
+	}
+	for(auto &w : workers)
+		w.join();
+
+	for(unsigned step = 1; step < threads; step *= 2)
+	{
+		workers.clear();
+		for(unsigned t = 0; t + step < threads; t += 2 * step)
+			workers.emplace_back([lists, &firsts, t, step] {
+				list_merge(lists[firsts[t]], lists[firsts[t + step]]);
+			});
+		for(auto &w : workers)
+			w.join();
+	}
+}
+
+#endif
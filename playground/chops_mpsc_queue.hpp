@@ -0,0 +1,157 @@
+#ifndef CHOPS_MPSC_QUEUE_H
+#define CHOPS_MPSC_QUEUE_H
+
+/*
+    This file contains an intrusive multi-producer single-consumer
+    queue of floats, the one described by Dmitry Vyukov.
+    http://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue
+
+    Producers link a node in with one atomic exchange on the head
+    and one store, there is no retry loop, so linking is wait-free
+    no matter what the other threads do. The consumer pops from the
+    tail without any atomic read-modify-write at all. A permanent
+    stub node keeps the queue from ever being truly empty, which is
+    what makes the two ends independent.
+
+    The nodes are the cnode_t of chops_concurrent_list, which have
+    the layout of node_t with an atomic next. Dequeued nodes are not
+    freed but go back to a lock-free stack of spare nodes, the same
+    tagged stack concurrent_list_t uses, and producers take their
+    nodes from there before asking the allocator. A producer tries
+    to take a spare only once, if another thread gets there first
+    it allocates a new node instead of retrying, so enqueue stays
+    wait-free as long as the allocator is.
+
+    Only one thread may call the dequeue functions at a time.
+*/
+
+#include <playground/chops_concurrent_list.hpp>
+
+typedef struct mpsc_queue {
+    std::atomic<cnode_t *> head;     // last enqueued node, producers swap it
+    cnode_t *tail;                   // next node to dequeue, consumer only
+    cnode_t stub;
+    std::atomic<tagged_ptr_t> spare;
+}  mpsc_queue_t ;
+
+inline mpsc_queue_t* make_mpsc_queue()
+{
+    mpsc_queue_t *queue = new mpsc_queue_t;
+    queue->stub.next.store(NULL);
+    queue->head.store(&queue->stub);
+    queue->tail = &queue->stub;
+    queue->spare.store(0);
+    return queue;
+}
+
+// Not thread safe, every other thread must be done with the queue
+inline void destroy_mpsc_queue(mpsc_queue_t *queue)
+{
+    cnode_t *cur = queue->tail;
+    while(cur != NULL)
+    {
+        cnode_t *following = cur->next.load(std::memory_order_relaxed);
+        if(cur != &queue->stub)
+            delete cur;
+        cur = following;
+    }
+    cur = tagged_node(queue->spare.load());
+    while(cur != NULL)
+    {
+        cnode_t *following = cur->next.load(std::memory_order_relaxed);
+        delete cur;
+        cur = following;
+    }
+    delete queue;
+}
+
+inline void mpsc_link(mpsc_queue_t *queue, cnode_t *node)
+{
+    node->next.store(NULL, std::memory_order_relaxed);
+    cnode_t *prev = queue->head.exchange(node, std::memory_order_acq_rel);
+    // between the exchange and this store the consumer can not see
+    // node yet, it will simply find the queue empty for a moment
+    prev->next.store(node, std::memory_order_release);
+}
+
+inline void mpsc_enqueue(mpsc_queue_t *queue, float val)
+{
+    cnode_t *node = tagged_try_pop(queue->spare);
+    if(node == NULL)
+        node = new cnode_t;
+    node->value = val;
+    mpsc_link(queue, node);
+}
+
+// Unlinks the oldest node, NULL if there is none ready
+inline cnode_t* mpsc_unlink(mpsc_queue_t *queue)
+{
+    cnode_t *tail = queue->tail;
+    cnode_t *next = tail->next.load(std::memory_order_acquire);
+
+    if(tail == &queue->stub)
+    {
+        if(next == NULL)
+            return NULL;
+        queue->tail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if(next != NULL)
+    {
+        queue->tail = next;
+        return tail;
+    }
+    // tail looks like the last node. If it is not the head, a
+    // producer is half way through linking after it, try later.
+    if(tail != queue->head.load(std::memory_order_acquire))
+        return NULL;
+    // it really is the last one, put the stub behind it so that
+    // tail can be handed out without emptying the queue
+    mpsc_link(queue, &queue->stub);
+    next = tail->next.load(std::memory_order_acquire);
+    if(next != NULL)
+    {
+        queue->tail = next;
+        return tail;
+    }
+    return NULL;
+}
+
+// Returns 0 if nothing was ready
+inline int mpsc_dequeue(mpsc_queue_t *queue, float *val)
+{
+    cnode_t *node = mpsc_unlink(queue);
+    if(node == NULL)
+        return 0;
+    *val = node->value;
+    tagged_push(queue->spare, node);
+    return 1;
+}
+
+// Dequeues up to max values in FIFO order, returns how many. The
+// nodes are recycled together, with a single CAS.
+inline size_t mpsc_dequeue_batch(mpsc_queue_t *queue, float *vals, size_t max)
+{
+    cnode_t *first = NULL;
+    cnode_t *last = NULL;
+    size_t count = 0;
+
+    while(count < max)
+    {
+        cnode_t *node = mpsc_unlink(queue);
+        if(node == NULL)
+            break;
+        vals[count++] = node->value;
+        // no producer links after an unlinked node, so its next is ours
+        node->next.store(first, std::memory_order_relaxed);
+        if(first == NULL)
+            last = node;
+        first = node;
+    }
+    if(first != NULL)
+        tagged_push_chain(queue->spare, first, last);
+    return count;
+}
+
+#endif
@@ -0,0 +1,118 @@
+#ifndef CHOPS_PARALLEL_MAP_H
+#define CHOPS_PARALLEL_MAP_H
+
+/*
+    This file contains a multi-threaded map_each for long lists.
+    The hard part about splitting a singly linked list is that we
+    can only find the start of a segment by walking to it. So the
+    list is cut into segments of equal length, the start node of
+    each is found in one pass, and every segment is handed to a
+    thread pool as soon as its start is known. The calling thread
+    keeps walking while the workers run.
+
+    If the same list is mapped many times, the walk can be saved
+    with a segment_index_t, which caches the start nodes. It is
+    only valid until the list is modified.
+
+    Every node is passed to func exactly once, from exactly one
+    thread, so as long as func only touches its own node the
+    result is the same as map_each, whatever the scheduling.
+*/
+
+#include <future>
+#include <vector>
+#include <playground/chops_singlylist.hpp>
+#include <playground/chops_thread_pool.hpp>
+
+typedef struct segment_index {
+    size_t parts;
+    node_t **starts;
+    size_t *counts;
+}  segment_index_t ;
+
+inline size_t segment_length(size_t length, size_t parts, size_t i)
+{
+	return length / parts + (i < length % parts ? 1 : 0);
+}
+
+// One pass over list, records where each of parts segments begins
+inline segment_index_t* make_segment_index(list_t *list, size_t parts)
+{
+	segment_index_t *index = (segment_index_t *) calloc(1, sizeof(segment_index_t));
+	index->parts = parts;
+	index->starts = (node_t **) calloc(parts, sizeof(node_t *));
+	index->counts = (size_t *) calloc(parts, sizeof(size_t));
+
+	node_t *cur = list->head;
+	for(size_t i = 0; i < parts; i++)
+	{
+		index->starts[i] = cur;
+		index->counts[i] = segment_length(list->length, parts, i);
+		for(size_t j = 0; j < index->counts[i]; j++)
+			cur = cur->next;
+	}
+	return index;
+}
+
+inline void destroy_segment_index(segment_index_t *index)
+{
+	free(index->starts);
+	free(index->counts);
+	free(index);
+}
+
+inline void map_segment(node_t *cur, size_t count, void (*func)(node_t*))
+{
+	for(size_t i = 0; i < count; i++)
+	{
+		node_t *following = cur->next;
+		func(cur);
+		cur = following;
+	}
+}
+
+// Uses the cached segments of index
+inline void parallel_map_each(segment_index_t *index, void (*func)(node_t*),
+                              chops::thread_pool &pool)
+{
+	std::vector<std::future<void>> pending;
+	for(size_t i = 0; i < index->parts; i++)
+	{
+		node_t *start = index->starts[i];
+		size_t count = index->counts[i];
+		pending.push_back(pool.submit([start, count, func] {
+			map_segment(start, count, func);
+		}));
+	}
+	for(auto &p : pending)
+		p.get();
+}
+
+// Splits the list while mapping it, into a few segments per
+// pool thread so that uneven work still balances out
+inline void parallel_map_each(list_t *list, void (*func)(node_t*),
+                              chops::thread_pool &pool)
+{
+	size_t parts = pool.size() * 4;
+	if(parts > list->length)
+		parts = list->length;
+
+	std::vector<std::future<void>> pending;
+	node_t *cur = list->head;
+	for(size_t i = 0; i < parts; i++)
+	{
+		node_t *start = cur;
+		size_t count = segment_length(list->length, parts, i);
+		pending.push_back(pool.submit([start, count, func] {
+			map_segment(start, count, func);
+		}));
+		// the last segment needs no walk to find the one after it
+		if(i + 1 < parts)
+			for(size_t j = 0; j < count; j++)
+				cur = cur->next;
+	}
+	for(auto &p : pending)
+		p.get();
+}
+
+#endif
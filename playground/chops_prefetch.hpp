@@ -0,0 +1,18 @@
+#ifndef CHOPS_PREFETCH_H
+#define CHOPS_PREFETCH_H
+
+/*
+    CHOPS_PREFETCH(p) asks the CPU to start loading the cache line
+    p is in, so that it may be there by the time we read it. It is
+    only a hint, it never faults, so p does not have to point to
+    anything valid.
+*/
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <xmmintrin.h>
+#define CHOPS_PREFETCH(p) _mm_prefetch((const char *) (p), _MM_HINT_T0)
+#else
+#define CHOPS_PREFETCH(p) __builtin_prefetch(p)
+#endif
+
+#endif
@@ -0,0 +1,196 @@
+#ifndef CHOPS_SIMD_MAP_H
+#define CHOPS_SIMD_MAP_H
+
+/*
+    This file contains bulk arithmetic kernels over contiguous
+    blocks of floats. map_each calls a function pointer for each
+    element, which the compiler can neither inline nor vectorize.
+    When the values are stored in chunks (see chops_unrolled_list)
+    we can instead describe the operation as data, a kernel_t, and
+    run it over a whole block with SIMD instructions.
+
+    There are three implementations of every kernel: plain C,
+    SSE (4 floats at a time) and AVX2 with FMA (8 floats at a
+    time). The AVX2 one is compiled with a target attribute so the
+    rest of the program does not need -mavx2, and map_block picks
+    the best one the CPU supports the first time it is called.
+
+    The implementations give the same results bit for bit, except
+    for KERNEL_FMA. The AVX2 one rounds once, with a fused
+    multiply-add, while the others round the product and then the
+    sum, so the last bit may differ.
+*/
+
+#include <stddef.h>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHOPS_SIMD_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define CHOPS_TARGET_AVX2
+#else
+#define CHOPS_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif
+#endif
+
+typedef enum kernel_op {
+    KERNEL_SCALE,   // v = v * a
+    KERNEL_ADD,     // v = v + a
+    KERNEL_FMA,     // v = v * a + b
+    KERNEL_CLAMP    // v = min(max(v, a), b), NaN becomes a
+}  kernel_op_t ;
+
+typedef struct kernel {
+    kernel_op_t op;
+    float a;
+    float b;
+}  kernel_t ;
+
+typedef enum simd_level {
+    SIMD_UNKNOWN = 0,
+    SIMD_SCALAR,
+    SIMD_SSE,
+    SIMD_AVX2
+}  simd_level_t ;
+
+inline void map_block_scalar(float *v, size_t n, const kernel_t *k)
+{
+    size_t i;
+    switch(k->op)
+    {
+    case KERNEL_SCALE:
+        for(i = 0; i < n; i++) v[i] *= k->a;
+        break;
+    case KERNEL_ADD:
+        for(i = 0; i < n; i++) v[i] += k->a;
+        break;
+    case KERNEL_FMA:
+        for(i = 0; i < n; i++) v[i] = v[i] * k->a + k->b;
+        break;
+    case KERNEL_CLAMP:
+        // same operand order as maxps and minps, so NaN becomes a
+        // here too
+        for(i = 0; i < n; i++)
+        {
+            float t = v[i] > k->a ? v[i] : k->a;
+            v[i] = t < k->b ? t : k->b;
+        }
+        break;
+    }
+}
+
+#ifdef CHOPS_SIMD_X86
+
+// SSE is part of x86-64, so this one needs no target attribute
+inline void map_block_sse(float *v, size_t n, const kernel_t *k)
+{
+    const __m128 a = _mm_set1_ps(k->a);
+    const __m128 b = _mm_set1_ps(k->b);
+    size_t i = 0;
+
+    switch(k->op)
+    {
+    case KERNEL_SCALE:
+        for(; i + 4 <= n; i += 4)
+            _mm_storeu_ps(v + i, _mm_mul_ps(_mm_loadu_ps(v + i), a));
+        break;
+    case KERNEL_ADD:
+        for(; i + 4 <= n; i += 4)
+            _mm_storeu_ps(v + i, _mm_add_ps(_mm_loadu_ps(v + i), a));
+        break;
+    case KERNEL_FMA:
+        for(; i + 4 <= n; i += 4)
+            _mm_storeu_ps(v + i, _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(v + i), a), b));
+        break;
+    case KERNEL_CLAMP:
+        for(; i + 4 <= n; i += 4)
+            _mm_storeu_ps(v + i, _mm_min_ps(_mm_max_ps(_mm_loadu_ps(v + i), a), b));
+        break;
+    }
+    map_block_scalar(v + i, n - i, k);
+}
+
+CHOPS_TARGET_AVX2
+inline void map_block_avx2(float *v, size_t n, const kernel_t *k)
+{
+    const __m256 a = _mm256_set1_ps(k->a);
+    const __m256 b = _mm256_set1_ps(k->b);
+    size_t i = 0;
+
+    switch(k->op)
+    {
+    case KERNEL_SCALE:
+        for(; i + 8 <= n; i += 8)
+            _mm256_storeu_ps(v + i, _mm256_mul_ps(_mm256_loadu_ps(v + i), a));
+        break;
+    case KERNEL_ADD:
+        for(; i + 8 <= n; i += 8)
+            _mm256_storeu_ps(v + i, _mm256_add_ps(_mm256_loadu_ps(v + i), a));
+        break;
+    case KERNEL_FMA:
+        for(; i + 8 <= n; i += 8)
+            _mm256_storeu_ps(v + i, _mm256_fmadd_ps(_mm256_loadu_ps(v + i), a, b));
+        break;
+    case KERNEL_CLAMP:
+        for(; i + 8 <= n; i += 8)
+            _mm256_storeu_ps(v + i, _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(v + i), a), b));
+        break;
+    }
+    // the remainder is short, let SSE and then scalar code finish it
+    map_block_sse(v + i, n - i, k);
+}
+
+#endif
+
+inline simd_level_t detect_simd_level()
+{
+#if !defined(CHOPS_SIMD_X86)
+    return SIMD_SCALAR;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    int has_fma = (info[2] & (1 << 12)) != 0;
+    int has_osxsave = (info[2] & (1 << 27)) != 0;
+    __cpuidex(info, 7, 0);
+    int has_avx2 = (info[1] & (1 << 5)) != 0;
+    // the OS must also save the upper halves of ymm registers
+    if(has_fma && has_avx2 && has_osxsave && (_xgetbv(0) & 6) == 6)
+        return SIMD_AVX2;
+    return SIMD_SSE;
+#else
+    if(__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return SIMD_AVX2;
+    return SIMD_SSE;
+#endif
+}
+
+// Sorts call this from pool threads, so the level is a function
+// local static, which C++ initializes exactly once even then
+inline simd_level_t simd_level()
+{
+    static const simd_level_t level = detect_simd_level();
+    return level;
+}
+
+// Runs the kernel over n contiguous floats with the best
+// implementation available on this CPU
+inline void map_block(float *v, size_t n, const kernel_t *k)
+{
+#ifdef CHOPS_SIMD_X86
+    switch(simd_level())
+    {
+    case SIMD_AVX2:
+        map_block_avx2(v, n, k);
+        return;
+    case SIMD_SSE:
+        map_block_sse(v, n, k);
+        return;
+    default:
+        break;
+    }
+#endif
+    map_block_scalar(v, n, k);
+}
+
+#endif
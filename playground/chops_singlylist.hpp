@@ -1,172 +1,558 @@
-#ifndef CHOPS_SINGLYLIST_H
-#define CHOPS_SINGLYLIST_H
-
-/* 
-    This file contains a C-style singly linked list data
-    structure. We don't implement deletions for singly linked
-    lists because they are O(n). If you need frequent insertions
-    and deletions, use doubly linked list. The most important 
-    part, maybe, of a singly linked list is structure-sharing
-    ie. same node can be the head of many lists. In the case
-    where our lists are immutable, this property makes it very
-    easy to use with functional languages. cons lists in func.
-    languages are mostly singly linked, immutable data
-    structures.
-    https://www.wikiwand.com/en/Linked_list#/Singly_linked_linear_lists_vs._other_lists
-*/
-
-#include <stdlib.h>
-#include <stdio.h>
-
-typedef struct node {
-    float value;
-    struct node *next;
-}  node_t ;
-
-typedef struct list {
-   node_t *head;
-}  list_t ;
-
-list_t* make_list()
-{
-	// calloc 0 initializes, so lists have a NULL
-	// head at creation, and length 0 
-	return (list_t *) calloc(1, sizeof(list_t));
-}
-
-void destroy_list(list_t *list)
-{
-	if(list->head == NULL)
-		free(list);
-	else
-	{
-		node_t *cur = list->head;
-		node_t *following;
-		do
-		{
-			following = cur->next;
-			free(cur);
-			cur = following;
-		}while(following != NULL);
-		free(list);
-	}
-}
-
-// O(1) push front, "the real" singly list inserter
-void push_front(list_t *list, float val)
-{
-	node_t *node = (node_t *) calloc(1, sizeof(node_t));
-
-	node->value = val;
-	
-	if(list->head == NULL)
-		list->head = node;
-	else
-	{
-		node_t *cur = list->head;
-        node->next = cur;
-        list->head = node;
-	}
-}
-
-void push_back(list_t *list, float val)
-{
-	node_t *node = (node_t *) calloc(1, sizeof(node_t));
-
-	node->value = val;
-	
-	if(list->head == NULL)
-		list->head = node;
-	else
-	{
-		node_t *cur = list->head;
-		while(cur->next != NULL)
-			cur = cur->next;
-		cur->next = node;
-	}
-}
-
-void push_sorted(list_t *list, float val)
-{
-	node_t *node = (node_t *) calloc(1, sizeof(node_t));
-
-	node->value = val;
-	
-	if(list->head == NULL) // empty list
-		list->head = node;
-	else
-	{
-		node_t *cur = list->head;
-		node_t *before = NULL;
-		
-		while(cur != NULL && cur->value <= val)
-		{
-			before = cur;
-			cur = cur->next;
-		}
-		if(before == NULL) // if val falls into head
-		{
-			list->head = node;
-			node->next = cur;
-		}
-		else // if val falls into tail
-		{
-			node->next = before->next;
-			before->next = node;
-		}
-	}
-}
-
-/* 
-    Note that car and cdr like this shares the underlying data
-    with the callee. This means, we are actually using parts of 
-    a persistent data structure. So, deleting this persistent
-    thing using the tail pointer would be silly. This scheme 
-    makes sense only when we use a persistent data structure
-    and a garbage collector at times to reference count.
-*/
-node_t* car(list_t* list)
-{
-    return list->head;
-}
-
-list_t* cdr(list_t* list)
-{
-    list_t* tail = (list_t *) calloc(1, sizeof(list_t));
-    tail->head = list->head->next;
-    return tail;
-}
-
-// Some traverse helpers
-void double_node(node_t *n)
-{
-    n->value *= 2;
-}
-
-void print_node(node_t *n)
-{
-    printf("%f ", n->value);
-}
-
-node_t* next_node(node_t *cur)
-{
-	return cur->next;
-}
-
-void map_each(list_t *list, void (*func)(node_t*))
-{
-	node_t *cur = list->head;
-    while(cur != NULL)
-    {
-        func(cur);
-        cur = cur->next;
-    }
-}
-
-void print_list(list_t *list)
-{
-	map_each(list, print_node);
-	printf("\n");
-}
-
+#ifndef CHOPS_SINGLYLIST_H
+#define CHOPS_SINGLYLIST_H
+
+/* 
+    This file contains a C-style singly linked list data
+    structure. We don't implement deletions for singly linked
+    lists because they are O(n). If you need frequent insertions
+    and deletions, use doubly linked list. The most important 
+    part, maybe, of a singly linked list is structure-sharing
+    ie. same node can be the head of many lists. In the case
+    where our lists are immutable, this property makes it very
+    easy to use with functional languages. cons lists in func.
+    languages are mostly singly linked, immutable data
+    structures.
+    https://www.wikiwand.com/en/Linked_list#/Singly_linked_linear_lists_vs._other_lists
+
+    Functions are inline since other headers build on list_t
+    and this one ends up in more than one translation unit.
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdint.h>
+
+typedef struct node {
+    float value;
+    struct node *next;
+}  node_t ;
+
+// Nodes created in bulk share one allocation, the nodes
+// themselves follow this header in memory. Splitting a list
+// can leave a block's nodes in two lists, so blocks count
+// the lists referring to them.
+typedef struct node_block {
+    size_t count;
+    size_t refs;
+}  node_block_t ;
+
+// nodes is how many of the list's nodes are in block
+typedef struct block_ref {
+    node_block_t *block;
+    size_t nodes;
+    struct block_ref *next;
+}  block_ref_t ;
+
+// tail and length are bookkeeping so that push_back and
+// list_length do not need to walk the whole list. blocks
+// are the bulk allocations this list refers to, block_nodes
+// is how many of its nodes live in them. blocks_tail lets
+// another list take over the references in O(1).
+typedef struct list {
+   node_t *head;
+   node_t *tail;
+   size_t length;
+   block_ref_t *blocks;
+   block_ref_t *blocks_tail;
+   size_t block_nodes;
+}  list_t ;
+
+inline list_t* make_list()
+{
+	// calloc 0 initializes, so lists have a NULL
+	// head and tail at creation, and length 0 
+	return (list_t *) calloc(1, sizeof(list_t));
+}
+
+inline node_t* block_nodes(node_block_t *block)
+{
+	return (node_t *) (block + 1);
+}
+
+// A block's nodes as a range of addresses. Sorted by address, the
+// block a node is in can be found with a binary search instead of
+// trying every block the list refers to.
+typedef struct block_range {
+    uintptr_t first;
+    uintptr_t end;
+    block_ref_t *ref;
+    size_t kept;        // used by list_split_at
+}  block_range_t ;
+
+inline int compare_block_ranges(const void *a, const void *b)
+{
+	uintptr_t x = ((const block_range_t *) a)->first;
+	uintptr_t y = ((const block_range_t *) b)->first;
+	return x < y ? -1 : x > y;
+}
+
+// O(B log B) for B block references, NULL if there are none
+inline block_range_t* make_block_ranges(list_t *list, size_t *count)
+{
+	size_t n = 0;
+	for(block_ref_t *r = list->blocks; r != NULL; r = r->next)
+		n++;
+	*count = n;
+	if(n == 0)
+		return NULL;
+
+	block_range_t *ranges = (block_range_t *) malloc(n * sizeof(block_range_t));
+	size_t i = 0;
+	for(block_ref_t *r = list->blocks; r != NULL; r = r->next, i++)
+	{
+		ranges[i].first = (uintptr_t) block_nodes(r->block);
+		ranges[i].end = ranges[i].first + r->block->count * sizeof(node_t);
+		ranges[i].ref = r;
+	}
+	qsort(ranges, n, sizeof(block_range_t), compare_block_ranges);
+	return ranges;
+}
+
+// O(log B), NULL if node was allocated on its own
+inline block_range_t* find_block_range(block_range_t *ranges, size_t count, node_t *node)
+{
+	uintptr_t addr = (uintptr_t) node;
+	// lo ends up at the first range starting after node
+	size_t lo = 0;
+	size_t hi = count;
+	while(lo < hi)
+	{
+		size_t mid = lo + (hi - lo) / 2;
+		if(ranges[mid].first <= addr)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	if(lo == 0 || addr >= ranges[lo - 1].end)
+		return NULL;
+	return &ranges[lo - 1];
+}
+
+inline void link_block_ref(list_t *list, block_ref_t *ref, size_t nodes)
+{
+	ref->nodes = nodes;
+	ref->next = list->blocks;
+	if(list->blocks == NULL)
+		list->blocks_tail = ref;
+	list->blocks = ref;
+	list->block_nodes += nodes;
+}
+
+// nodes of the list are in block
+inline void add_block_ref(list_t *list, node_block_t *block, size_t nodes)
+{
+	block_ref_t *ref = (block_ref_t *) malloc(sizeof(block_ref_t));
+	ref->block = block;
+	block->refs++;
+	link_block_ref(list, ref, nodes);
+}
+
+// Drops this list's references, a block goes with its last one
+inline void free_blocks(list_t *list)
+{
+	block_ref_t *ref = list->blocks;
+	while(ref != NULL)
+	{
+		block_ref_t *following = ref->next;
+		if(--ref->block->refs == 0)
+			free(ref->block);
+		free(ref);
+		ref = following;
+	}
+	list->blocks = NULL;
+	list->blocks_tail = NULL;
+	list->block_nodes = 0;
+}
+
+inline void destroy_list(list_t *list)
+{
+	// if every node came in bulk there is nothing to walk
+	if(list->head != NULL && list->block_nodes != list->length)
+	{
+		size_t count;
+		block_range_t *ranges = make_block_ranges(list, &count);
+		node_t *cur = list->head;
+		node_t *following;
+		do
+		{
+			following = cur->next;
+			if(find_block_range(ranges, count, cur) == NULL)
+				free(cur);
+			cur = following;
+		}while(following != NULL);
+		free(ranges);
+	}
+
+	free_blocks(list);
+	free(list);
+}
+
+// O(1) push front, "the real" singly list inserter
+inline void push_front(list_t *list, float val)
+{
+	node_t *node = (node_t *) calloc(1, sizeof(node_t));
+
+	node->value = val;
+	
+	if(list->head == NULL)
+	{
+		list->head = node;
+		list->tail = node;
+	}
+	else
+	{
+		node_t *cur = list->head;
+        node->next = cur;
+        list->head = node;
+	}
+	list->length++;
+}
+
+// O(1) as well, since we keep track of the tail
+inline void push_back(list_t *list, float val)
+{
+	node_t *node = (node_t *) calloc(1, sizeof(node_t));
+
+	node->value = val;
+	
+	if(list->head == NULL)
+		list->head = node;
+	else
+		list->tail->next = node;
+	list->tail = node;
+	list->length++;
+}
+
+inline void push_sorted(list_t *list, float val)
+{
+	node_t *node = (node_t *) calloc(1, sizeof(node_t));
+
+	node->value = val;
+	
+	if(list->head == NULL) // empty list
+	{
+		list->head = node;
+		list->tail = node;
+	}
+	else
+	{
+		node_t *cur = list->head;
+		node_t *before = NULL;
+		
+		while(cur != NULL && cur->value <= val)
+		{
+			before = cur;
+			cur = cur->next;
+		}
+		if(before == NULL) // if val falls into head
+		{
+			list->head = node;
+			node->next = cur;
+		}
+		else // if val falls into tail
+		{
+			node->next = before->next;
+			before->next = node;
+			if(node->next == NULL)
+				list->tail = node;
+		}
+	}
+	list->length++;
+}
+
+// Appends count values with a single allocation. The nodes
+// are laid out in order, so traversing them is sequential.
+inline void list_append_array(list_t *list, const float *values, size_t count)
+{
+	if(count == 0)
+		return;
+
+	node_block_t *block = (node_block_t *) malloc(sizeof(node_block_t) +
+	                                              count * sizeof(node_t));
+	node_t *nodes = block_nodes(block);
+
+	for(size_t i = 0; i < count; i++)
+	{
+		nodes[i].value = values[i];
+		nodes[i].next = &nodes[i + 1];
+	}
+	nodes[count - 1].next = NULL;
+
+	if(list->head == NULL)
+		list->head = nodes;
+	else
+		list->tail->next = nodes;
+	list->tail = &nodes[count - 1];
+	list->length += count;
+
+	block->count = count;
+	block->refs = 0;
+	add_block_ref(list, block, count);
+}
+
+inline list_t* list_from_array(const float *values, size_t count)
+{
+	list_t *list = make_list();
+	list_append_array(list, values, count);
+	return list;
+}
+
+/*
+    After many push_front and push_sorted calls the nodes are all
+    over the heap and every step of a traversal is a cache miss.
+    list_compact moves the values into one new block, in traversal
+    order, and frees the old nodes. Pointers to the old nodes are
+    no longer valid afterwards.
+*/
+inline void list_compact(list_t *list)
+{
+	if(list->head == NULL)
+		return;
+
+	size_t count = list->length;
+	node_block_t *block = (node_block_t *) malloc(sizeof(node_block_t) +
+	                                              count * sizeof(node_t));
+	node_t *nodes = block_nodes(block);
+	node_t *cur = list->head;
+	size_t range_count;
+	block_range_t *ranges = make_block_ranges(list, &range_count);
+
+	for(size_t i = 0; i < count; i++)
+	{
+		node_t *following = cur->next;
+		nodes[i].value = cur->value;
+		nodes[i].next = &nodes[i + 1];
+		if(find_block_range(ranges, range_count, cur) == NULL)
+			free(cur);
+		cur = following;
+	}
+	nodes[count - 1].next = NULL;
+	free(ranges);
+	free_blocks(list);
+
+	block->count = count;
+	block->refs = 0;
+	add_block_ref(list, block, count);
+	list->head = nodes;
+	list->tail = &nodes[count - 1];
+}
+
+inline size_t list_length(list_t *list)
+{
+	return list->length;
+}
+
+/*
+    Combining lists by relinking. None of these allocate nodes or
+    copy values. Nodes that move to another list take the block
+    references with them, so destroy_list still frees everything
+    exactly once.
+*/
+inline void move_blocks(list_t *dst, list_t *src)
+{
+	if(src->blocks != NULL)
+	{
+		src->blocks_tail->next = dst->blocks;
+		if(dst->blocks == NULL)
+			dst->blocks_tail = src->blocks_tail;
+		dst->blocks = src->blocks;
+	}
+	dst->block_nodes += src->block_nodes;
+	src->blocks = NULL;
+	src->blocks_tail = NULL;
+	src->block_nodes = 0;
+}
+
+// O(1), all nodes of src go to the end of dst and src is left empty
+inline void list_concat(list_t *dst, list_t *src)
+{
+	if(src->head != NULL)
+	{
+		if(dst->head == NULL)
+			dst->head = src->head;
+		else
+			dst->tail->next = src->head;
+		dst->tail = src->tail;
+		dst->length += src->length;
+	}
+	src->head = NULL;
+	src->tail = NULL;
+	src->length = 0;
+	move_blocks(dst, src);
+}
+
+// O(1), all nodes of src go after pos, or to the front of dst if
+// pos is NULL, and src is left empty
+inline void list_splice_after(list_t *dst, node_t *pos, list_t *src)
+{
+	if(src->head != NULL)
+	{
+		if(pos == NULL)
+		{
+			src->tail->next = dst->head;
+			dst->head = src->head;
+		}
+		else
+		{
+			src->tail->next = pos->next;
+			pos->next = src->head;
+		}
+		if(dst->tail == pos)
+			dst->tail = src->tail;
+		dst->length += src->length;
+	}
+	src->head = NULL;
+	src->tail = NULL;
+	src->length = 0;
+	move_blocks(dst, src);
+}
+
+// Keeps the first count nodes in list and returns the rest as a
+// new list. Finding the cut is O(count log B) for B blocks, the cut
+// itself is O(1). Each half keeps references only to the blocks it
+// has nodes in, so the only allocations are the new list and a
+// reference for each block that the cut goes through.
+inline list_t* list_split_at(list_t *list, size_t count)
+{
+	list_t *rest = make_list();
+	if(count >= list->length)
+		return rest;
+
+	size_t range_count;
+	block_range_t *ranges = make_block_ranges(list, &range_count);
+
+	// joining the halves of an earlier split leaves a block referred
+	// to twice, fold those into one reference
+	size_t unique = 0;
+	for(size_t i = 0; i < range_count; i++)
+	{
+		if(unique > 0 && ranges[unique - 1].first == ranges[i].first)
+		{
+			ranges[unique - 1].ref->nodes += ranges[i].ref->nodes;
+			ranges[i].ref->block->refs--;
+			free(ranges[i].ref);
+		}
+		else
+			ranges[unique++] = ranges[i];
+	}
+	range_count = unique;
+
+	// nodes of each block that stay, counted in ranges[i].kept
+	node_t *before = NULL;
+	node_t *cur = list->head;
+	for(size_t i = 0; i < range_count; i++)
+		ranges[i].kept = 0;
+	for(size_t i = 0; i < count; i++)
+	{
+		block_range_t *range = find_block_range(ranges, range_count, cur);
+		if(range != NULL)
+			range->kept++;
+		before = cur;
+		cur = cur->next;
+	}
+
+	rest->head = cur;
+	rest->tail = list->tail;
+	rest->length = list->length - count;
+	if(before == NULL)
+		list->head = NULL;
+	else
+		before->next = NULL;
+	list->tail = before;
+	list->length = count;
+
+	list->blocks = NULL;
+	list->blocks_tail = NULL;
+	list->block_nodes = 0;
+	for(size_t i = 0; i < range_count; i++)
+	{
+		block_ref_t *ref = ranges[i].ref;
+		size_t kept = ranges[i].kept;
+		size_t moved = ref->nodes - kept;
+		if(kept > 0 && moved > 0)
+			add_block_ref(rest, ref->block, moved);
+		else if(moved > 0)
+			link_block_ref(rest, ref, moved);
+		if(kept > 0)
+			link_block_ref(list, ref, kept);
+	}
+	free(ranges);
+	return rest;
+}
+
+// In place, O(n) and no allocation
+inline void list_reverse(list_t *list)
+{
+	node_t *prev = NULL;
+	node_t *cur = list->head;
+	while(cur != NULL)
+	{
+		node_t *following = cur->next;
+		cur->next = prev;
+		prev = cur;
+		cur = following;
+	}
+	list->tail = list->head;
+	list->head = prev;
+}
+
+/* 
+    Note that car and cdr like this shares the underlying data
+    with the callee. This means, we are actually using parts of 
+    a persistent data structure. So, deleting this persistent
+    thing using the tail pointer would be silly. This scheme 
+    makes sense only when we use a persistent data structure
+    and a garbage collector at times to reference count.
+    chops_cons_list.hpp is exactly that, a reference counted
+    persistent list where cdr does not allocate.
+*/
+inline node_t* car(list_t* list)
+{
+    return list->head;
+}
+
+inline list_t* cdr(list_t* list)
+{
+    list_t* tail = (list_t *) calloc(1, sizeof(list_t));
+    tail->head = list->head->next;
+    if(tail->head != NULL)
+    {
+        tail->tail = list->tail;
+        tail->length = list->length - 1;
+    }
+    return tail;
+}
+
+// Some traverse helpers
+inline void double_node(node_t *n)
+{
+    n->value *= 2;
+}
+
+inline void print_node(node_t *n)
+{
+    printf("%f ", n->value);
+}
+
+inline node_t* next_node(node_t *cur)
+{
+	return cur->next;
+}
+
+inline void map_each(list_t *list, void (*func)(node_t*))
+{
+	node_t *cur = list->head;
+    while(cur != NULL)
+    {
+        func(cur);
+        cur = cur->next;
+    }
+}
+
+inline void print_list(list_t *list)
+{
+	map_each(list, print_node);
+	printf("\n");
+}
+
 #endif
\ No newline at end of file
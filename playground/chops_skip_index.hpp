@@ -0,0 +1,183 @@
+#ifndef CHOPS_SKIP_INDEX_H
+#define CHOPS_SKIP_INDEX_H
+
+/*
+    This file contains an optional skip list index over a sorted
+    list_t. push_sorted has to walk from the head to find where a
+    value goes, which is O(n) per insert. The index adds express
+    lanes on top of the list: about one node in SKIP_FANOUT gets a
+    tower, and a tower of height h links to the next tower of at
+    least that height on each of its h levels, so each level skips
+    SKIP_FANOUT times further than the one below it. A search starts
+    on the top lane, drops a level whenever the next tower would
+    overshoot, and finishes with a short walk on the list itself,
+    which makes insert and lookup expected O(log n).
+    https://www.wikiwand.com/en/Skip_list
+
+    The list is not changed in any way, nodes stay linked through
+    next and map_each, print_list etc. work as before. Only inserts
+    have to go through skip_push_sorted while an index exists, the
+    index does not see nodes added behind its back.
+*/
+
+#include <stdint.h>
+#include <playground/chops_singlylist.hpp>
+
+#define SKIP_MAX_LEVEL 16
+#define SKIP_FANOUT 4
+
+typedef struct skip_tower {
+    node_t *node;
+    int height;
+    struct skip_tower **forward; // height entries, allocated with the tower
+}  skip_tower_t ;
+
+typedef struct skip_index {
+    list_t *list;
+    skip_tower_t *lanes;         // sentinel of SKIP_MAX_LEVEL height, node is NULL
+    uint32_t seed;
+}  skip_index_t ;
+
+inline skip_tower_t* make_tower(node_t *node, int height)
+{
+	skip_tower_t *tower = (skip_tower_t *) calloc(1, sizeof(skip_tower_t) +
+	                                                 height * sizeof(skip_tower_t *));
+	tower->node = node;
+	tower->height = height;
+	tower->forward = (skip_tower_t **) (tower + 1);
+	return tower;
+}
+
+// Height 0, ie. no tower, with probability 1 - 1/SKIP_FANOUT,
+// height h with probability (1/SKIP_FANOUT)^h after that.
+// xorshift32 is plenty for coin flips.
+inline int random_tower_height(skip_index_t *index)
+{
+	int height = 0;
+	for(;;)
+	{
+		uint32_t x = index->seed;
+		x ^= x << 13;
+		x ^= x >> 17;
+		x ^= x << 5;
+		index->seed = x;
+		if(x % SKIP_FANOUT != 0 || height == SKIP_MAX_LEVEL)
+			return height;
+		height++;
+	}
+}
+
+// Links a new tower after update[l] on each of its levels
+inline void link_tower(skip_index_t *index, node_t *node, skip_tower_t **update)
+{
+	int height = random_tower_height(index);
+	if(height == 0)
+		return;
+
+	skip_tower_t *tower = make_tower(node, height);
+	for(int l = 0; l < height; l++)
+	{
+		tower->forward[l] = update[l]->forward[l];
+		update[l]->forward[l] = tower;
+	}
+}
+
+// O(n) build over an existing sorted list
+inline skip_index_t* make_skip_index(list_t *list)
+{
+	skip_index_t *index = (skip_index_t *) calloc(1, sizeof(skip_index_t));
+	skip_tower_t *last[SKIP_MAX_LEVEL];
+
+	index->list = list;
+	index->lanes = make_tower(NULL, SKIP_MAX_LEVEL);
+	index->seed = 2463534242u;
+
+	for(int l = 0; l < SKIP_MAX_LEVEL; l++)
+		last[l] = index->lanes;
+	for(node_t *cur = list->head; cur != NULL; cur = cur->next)
+	{
+		// appending, so the last tower of each level is the predecessor
+		link_tower(index, cur, last);
+		for(int l = 0; l < SKIP_MAX_LEVEL && last[l]->forward[l] != NULL; l++)
+			last[l] = last[l]->forward[l];
+	}
+	return index;
+}
+
+// Frees the towers only, the list stays as it is
+inline void destroy_skip_index(skip_index_t *index)
+{
+	skip_tower_t *cur = index->lanes;
+	while(cur != NULL)
+	{
+		skip_tower_t *following = cur->forward[0];
+		free(cur);
+		cur = following;
+	}
+	free(index);
+}
+
+// Fills update with the last tower on each level whose value is
+// less than val, or less than or equal to it if inclusive is set.
+// Returns the list node that the search ends on, NULL if it did
+// not get past the sentinel.
+inline node_t* skip_descend(skip_index_t *index, float val, int inclusive,
+                            skip_tower_t **update)
+{
+	skip_tower_t *cur = index->lanes;
+	for(int l = SKIP_MAX_LEVEL - 1; l >= 0; l--)
+	{
+		skip_tower_t *next;
+		while((next = cur->forward[l]) != NULL &&
+		      (next->node->value < val || (inclusive && next->node->value == val)))
+			cur = next;
+		update[l] = cur;
+	}
+	return cur->node;
+}
+
+// Same result as push_sorted, equal values keep insertion order,
+// but expected O(log n)
+inline void skip_push_sorted(skip_index_t *index, float val)
+{
+	list_t *list = index->list;
+	skip_tower_t *update[SKIP_MAX_LEVEL];
+	node_t *before = skip_descend(index, val, 1, update);
+	node_t *cur = before == NULL ? list->head : before->next;
+
+	// the rest of the way is on the list, SKIP_FANOUT nodes expected
+	while(cur != NULL && cur->value <= val)
+	{
+		before = cur;
+		cur = cur->next;
+	}
+
+	node_t *node = (node_t *) calloc(1, sizeof(node_t));
+	node->value = val;
+	node->next = cur;
+	if(before == NULL)
+		list->head = node;
+	else
+		before->next = node;
+	if(cur == NULL)
+		list->tail = node;
+	list->length++;
+
+	link_tower(index, node, update);
+}
+
+// Expected O(log n), returns the first node holding val or NULL
+inline node_t* skip_find(skip_index_t *index, float val)
+{
+	skip_tower_t *update[SKIP_MAX_LEVEL];
+	node_t *before = skip_descend(index, val, 0, update);
+	node_t *cur = before == NULL ? index->list->head : before->next;
+
+	while(cur != NULL && cur->value < val)
+		cur = cur->next;
+	if(cur != NULL && cur->value == val)
+		return cur;
+	return NULL;
+}
+
+#endif
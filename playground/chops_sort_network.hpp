@@ -0,0 +1,313 @@
+#ifndef CHOPS_SORT_NETWORK_H
+#define CHOPS_SORT_NETWORK_H
+
+/*
+    This file contains SIMD sorting networks for small arrays of
+    float, int32_t and double. A sorting network is a fixed list of
+    compare-exchange steps that does not depend on the data, so it
+    has no branches to mispredict. The steps of a bitonic network
+    come in stages of independent pairs, which is exactly what a
+    vector min and max do a register at a time.
+
+    Arrays of SORT_NETWORK_MIN to SORT_NETWORK_MAX values are padded
+    up to the next power of two with the largest value of the type,
+    then sorted by a bitonic network. Pairs that are a register or
+    more apart are one min and one max on two loads. Pairs within a
+    register are a lane shuffle, a min, a max and a blend.
+
+    As in chops_simd_map, there is an AVX2 version (8 floats or
+    ints, or 4 doubles, per register) compiled with a target
+    attribute and an SSE2 version, and the first call picks one.
+    The network body is written once and stamped out for every
+    type and instruction set by CHOPS_DEFINE_SORT_NETWORK, because
+    a function can only inline intrinsics of its own target.
+
+    The sort_network_ functions return 0 and leave the array alone
+    when they can't help: sizes out of range, CPUs that are not
+    x86, and arrays with a NaN, which min and max would duplicate.
+    The network is not stable, only -0.0 and 0.0 can tell.
+*/
+
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <playground/chops_simd_map.hpp>
+
+#define SORT_NETWORK_MIN 8
+#define SORT_NETWORK_MAX 64
+
+// What the network needs, per instruction set and type: load, store,
+// min, max, swap_lanes (lane l with lane l ^ j, j a power of two
+// below the lane count), mask (all ones in the lanes set in bits)
+// and select (a where the mask is set, b elsewhere)
+
+#ifdef CHOPS_SIMD_X86
+
+typedef __m128 net_vec_sse_float;
+typedef __m128i net_vec_sse_int32;
+typedef __m128d net_vec_sse_double;
+static const size_t net_lanes_sse_float = 4;
+static const size_t net_lanes_sse_int32 = 4;
+static const size_t net_lanes_sse_double = 2;
+
+inline __m128 net_load_sse_float(const float *p) { return _mm_loadu_ps(p); }
+inline void net_store_sse_float(float *p, __m128 v) { _mm_storeu_ps(p, v); }
+inline __m128 net_min_sse_float(__m128 a, __m128 b) { return _mm_min_ps(a, b); }
+inline __m128 net_max_sse_float(__m128 a, __m128 b) { return _mm_max_ps(a, b); }
+inline __m128 net_swap_lanes_sse_float(__m128 v, size_t j)
+{
+    return j == 1 ? _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1))
+                  : _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2));
+}
+inline __m128 net_mask_sse_float(unsigned bits)
+{
+    return _mm_castsi128_ps(_mm_setr_epi32(-(int) (bits & 1), -(int) ((bits >> 1) & 1),
+                                           -(int) ((bits >> 2) & 1), -(int) ((bits >> 3) & 1)));
+}
+inline __m128 net_select_sse_float(__m128 m, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b));
+}
+
+inline __m128i net_load_sse_int32(const int32_t *p) { return _mm_loadu_si128((const __m128i *) p); }
+inline void net_store_sse_int32(int32_t *p, __m128i v) { _mm_storeu_si128((__m128i *) p, v); }
+inline __m128i net_select_sse_int32(__m128i m, __m128i a, __m128i b)
+{
+    return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b));
+}
+// SSE2 has no 32-bit min and max, that came with SSE4.1
+inline __m128i net_min_sse_int32(__m128i a, __m128i b)
+{
+    return net_select_sse_int32(_mm_cmpgt_epi32(a, b), b, a);
+}
+inline __m128i net_max_sse_int32(__m128i a, __m128i b)
+{
+    return net_select_sse_int32(_mm_cmpgt_epi32(a, b), a, b);
+}
+inline __m128i net_swap_lanes_sse_int32(__m128i v, size_t j)
+{
+    return j == 1 ? _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1))
+                  : _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+}
+inline __m128i net_mask_sse_int32(unsigned bits)
+{
+    return _mm_castps_si128(net_mask_sse_float(bits));
+}
+
+inline __m128d net_load_sse_double(const double *p) { return _mm_loadu_pd(p); }
+inline void net_store_sse_double(double *p, __m128d v) { _mm_storeu_pd(p, v); }
+inline __m128d net_min_sse_double(__m128d a, __m128d b) { return _mm_min_pd(a, b); }
+inline __m128d net_max_sse_double(__m128d a, __m128d b) { return _mm_max_pd(a, b); }
+inline __m128d net_swap_lanes_sse_double(__m128d v, size_t)
+{
+    return _mm_shuffle_pd(v, v, 1);
+}
+inline __m128d net_mask_sse_double(unsigned bits)
+{
+    return _mm_castsi128_pd(_mm_set_epi64x(-(long long) ((bits >> 1) & 1), -(long long) (bits & 1)));
+}
+inline __m128d net_select_sse_double(__m128d m, __m128d a, __m128d b)
+{
+    return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b));
+}
+
+typedef __m256 net_vec_avx2_float;
+typedef __m256i net_vec_avx2_int32;
+typedef __m256d net_vec_avx2_double;
+static const size_t net_lanes_avx2_float = 8;
+static const size_t net_lanes_avx2_int32 = 8;
+static const size_t net_lanes_avx2_double = 4;
+
+CHOPS_TARGET_AVX2 inline __m256 net_load_avx2_float(const float *p) { return _mm256_loadu_ps(p); }
+CHOPS_TARGET_AVX2 inline void net_store_avx2_float(float *p, __m256 v) { _mm256_storeu_ps(p, v); }
+CHOPS_TARGET_AVX2 inline __m256 net_min_avx2_float(__m256 a, __m256 b) { return _mm256_min_ps(a, b); }
+CHOPS_TARGET_AVX2 inline __m256 net_max_avx2_float(__m256 a, __m256 b) { return _mm256_max_ps(a, b); }
+CHOPS_TARGET_AVX2 inline __m256 net_swap_lanes_avx2_float(__m256 v, size_t j)
+{
+    if(j == 1)
+        return _mm256_permute_ps(v, _MM_SHUFFLE(2, 3, 0, 1));
+    if(j == 2)
+        return _mm256_permute_ps(v, _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm256_permute2f128_ps(v, v, 1);
+}
+CHOPS_TARGET_AVX2 inline __m256i net_mask_avx2_int32(unsigned bits)
+{
+    const __m256i lane_bits = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+    return _mm256_cmpeq_epi32(_mm256_and_si256(_mm256_set1_epi32((int) bits), lane_bits), lane_bits);
+}
+CHOPS_TARGET_AVX2 inline __m256 net_mask_avx2_float(unsigned bits)
+{
+    return _mm256_castsi256_ps(net_mask_avx2_int32(bits));
+}
+CHOPS_TARGET_AVX2 inline __m256 net_select_avx2_float(__m256 m, __m256 a, __m256 b)
+{
+    return _mm256_blendv_ps(b, a, m);
+}
+
+CHOPS_TARGET_AVX2 inline __m256i net_load_avx2_int32(const int32_t *p) { return _mm256_loadu_si256((const __m256i *) p); }
+CHOPS_TARGET_AVX2 inline void net_store_avx2_int32(int32_t *p, __m256i v) { _mm256_storeu_si256((__m256i *) p, v); }
+CHOPS_TARGET_AVX2 inline __m256i net_min_avx2_int32(__m256i a, __m256i b) { return _mm256_min_epi32(a, b); }
+CHOPS_TARGET_AVX2 inline __m256i net_max_avx2_int32(__m256i a, __m256i b) { return _mm256_max_epi32(a, b); }
+CHOPS_TARGET_AVX2 inline __m256i net_swap_lanes_avx2_int32(__m256i v, size_t j)
+{
+    if(j == 1)
+        return _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    if(j == 2)
+        return _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm256_permute2x128_si256(v, v, 1);
+}
+CHOPS_TARGET_AVX2 inline __m256i net_select_avx2_int32(__m256i m, __m256i a, __m256i b)
+{
+    return _mm256_blendv_epi8(b, a, m);
+}
+
+CHOPS_TARGET_AVX2 inline __m256d net_load_avx2_double(const double *p) { return _mm256_loadu_pd(p); }
+CHOPS_TARGET_AVX2 inline void net_store_avx2_double(double *p, __m256d v) { _mm256_storeu_pd(p, v); }
+CHOPS_TARGET_AVX2 inline __m256d net_min_avx2_double(__m256d a, __m256d b) { return _mm256_min_pd(a, b); }
+CHOPS_TARGET_AVX2 inline __m256d net_max_avx2_double(__m256d a, __m256d b) { return _mm256_max_pd(a, b); }
+CHOPS_TARGET_AVX2 inline __m256d net_swap_lanes_avx2_double(__m256d v, size_t j)
+{
+    if(j == 1)
+        return _mm256_permute_pd(v, 0x5);
+    return _mm256_permute2f128_pd(v, v, 1);
+}
+CHOPS_TARGET_AVX2 inline __m256d net_mask_avx2_double(unsigned bits)
+{
+    const __m256i lane_bits = _mm256_setr_epi64x(1, 2, 4, 8);
+    return _mm256_castsi256_pd(_mm256_cmpeq_epi64(
+        _mm256_and_si256(_mm256_set1_epi64x((long long) bits), lane_bits), lane_bits));
+}
+CHOPS_TARGET_AVX2 inline __m256d net_select_avx2_double(__m256d m, __m256d a, __m256d b)
+{
+    return _mm256_blendv_pd(b, a, m);
+}
+
+/*
+    Bitonic sort of n values, n a power of two and at least one
+    register. Stage (k, j) compare-exchanges every i with i ^ j,
+    ascending where i & k is 0 and descending elsewhere. Within a
+    register the blend mask says which lanes keep the min: the
+    lower lane of a pair in an ascending block, or the upper one
+    in a descending block.
+
+    minps and friends return their second operand when the inputs
+    compare equal, so min(a, b) and max(a, b) would both be b. For
+    -0.0 and 0.0 one would be duplicated and the other lost, so max
+    takes its operands the other way round. Within a register each
+    lane does that by itself, the partner's lane sees a and p
+    swapped. The network is not stable, -0.0 and 0.0 may come out
+    in either order, but it is a permutation of its input.
+*/
+#define CHOPS_DEFINE_SORT_NETWORK(sfx, T, TARGET)                                     \
+TARGET inline void sort_network_pow2_##sfx(T *v, size_t n)                            \
+{                                                                                     \
+    const size_t lanes = net_lanes_##sfx;                                             \
+    const unsigned all = (1u << lanes) - 1;                                           \
+    for(size_t k = 2; k <= n; k <<= 1)                                                \
+        for(size_t j = k >> 1; j > 0; j >>= 1)                                        \
+        {                                                                             \
+            if(j >= lanes)                                                            \
+            {                                                                         \
+                for(size_t i = 0; i < n; i += lanes)                                  \
+                {                                                                     \
+                    if(i & j)                                                         \
+                        continue;                                                     \
+                    net_vec_##sfx a = net_load_##sfx(v + i);                          \
+                    net_vec_##sfx b = net_load_##sfx(v + i + j);                      \
+                    /* b, a: on equal inputs min and max both return b */             \
+                    net_vec_##sfx lo = net_min_##sfx(a, b);                           \
+                    net_vec_##sfx hi = net_max_##sfx(b, a);                           \
+                    net_store_##sfx(v + i, (i & k) ? hi : lo);                        \
+                    net_store_##sfx(v + i + j, (i & k) ? lo : hi);                    \
+                }                                                                     \
+                continue;                                                             \
+            }                                                                         \
+            unsigned low = 0, desc = 0;                                               \
+            for(size_t l = 0; l < lanes; l++)                                         \
+            {                                                                         \
+                if(!(l & j))                                                          \
+                    low |= 1u << l;                                                   \
+                if(k < lanes && (l & k))                                              \
+                    desc |= 1u << l;                                                  \
+            }                                                                         \
+            net_vec_##sfx up = net_mask_##sfx(low ^ desc);                            \
+            net_vec_##sfx down = net_mask_##sfx(low ^ desc ^ all);                    \
+            for(size_t i = 0; i < n; i += lanes)                                      \
+            {                                                                         \
+                net_vec_##sfx a = net_load_##sfx(v + i);                              \
+                net_vec_##sfx p = net_swap_lanes_##sfx(a, j);                         \
+                net_vec_##sfx m = (k >= lanes && (i & k)) ? down : up;                \
+                net_store_##sfx(v + i, net_select_##sfx(m, net_min_##sfx(a, p),       \
+                                                        net_max_##sfx(a, p)));        \
+            }                                                                         \
+        }                                                                             \
+}
+
+CHOPS_DEFINE_SORT_NETWORK(sse_float, float, )
+CHOPS_DEFINE_SORT_NETWORK(sse_int32, int32_t, )
+CHOPS_DEFINE_SORT_NETWORK(sse_double, double, )
+CHOPS_DEFINE_SORT_NETWORK(avx2_float, float, CHOPS_TARGET_AVX2)
+CHOPS_DEFINE_SORT_NETWORK(avx2_int32, int32_t, CHOPS_TARGET_AVX2)
+CHOPS_DEFINE_SORT_NETWORK(avx2_double, double, CHOPS_TARGET_AVX2)
+
+#endif
+
+// The power of two the network for n values works on
+inline size_t sort_network_size(size_t n)
+{
+    size_t size = SORT_NETWORK_MIN;
+    while(size < n)
+        size <<= 1;
+    return size;
+}
+
+/*
+    sort_network_float, sort_network_int32 and sort_network_double.
+    Values are copied to a padded buffer on the stack unless n is
+    already a power of two. v != v only holds for NaN.
+*/
+#ifdef CHOPS_SIMD_X86
+#define CHOPS_DEFINE_SORT_NETWORK_ENTRY(name, T, PAD)                                 \
+inline int sort_network_##name(T *v, size_t n)                                        \
+{                                                                                     \
+    if(n < SORT_NETWORK_MIN || n > SORT_NETWORK_MAX)                                  \
+        return 0;                                                                     \
+    simd_level_t level = simd_level();                                                \
+    if(level != SIMD_AVX2 && level != SIMD_SSE)                                       \
+        return 0;                                                                     \
+    for(size_t i = 0; i < n; i++)                                                     \
+        if(v[i] != v[i])                                                              \
+            return 0;                                                                 \
+                                                                                      \
+    T buf[SORT_NETWORK_MAX];                                                          \
+    size_t size = sort_network_size(n);                                               \
+    T *data = size == n ? v : buf;                                                    \
+    if(data == buf)                                                                   \
+    {                                                                                 \
+        for(size_t i = 0; i < n; i++)                                                 \
+            buf[i] = v[i];                                                            \
+        for(size_t i = n; i < size; i++)                                              \
+            buf[i] = PAD;                                                             \
+    }                                                                                 \
+    if(level == SIMD_AVX2)                                                            \
+        sort_network_pow2_avx2_##name(data, size);                                    \
+    else                                                                              \
+        sort_network_pow2_sse_##name(data, size);                                     \
+    if(data == buf)                                                                   \
+        for(size_t i = 0; i < n; i++)                                                 \
+            v[i] = buf[i];                                                            \
+    return 1;                                                                         \
+}
+#else
+#define CHOPS_DEFINE_SORT_NETWORK_ENTRY(name, T, PAD)                                 \
+inline int sort_network_##name(T *, size_t)                                           \
+{                                                                                     \
+    return 0;                                                                         \
+}
+#endif
+
+CHOPS_DEFINE_SORT_NETWORK_ENTRY(float, float, INFINITY)
+CHOPS_DEFINE_SORT_NETWORK_ENTRY(int32, int32_t, INT32_MAX)
+CHOPS_DEFINE_SORT_NETWORK_ENTRY(double, double, (double) INFINITY)
+
+#endif
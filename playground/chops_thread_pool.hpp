@@ -0,0 +1,265 @@
+#ifndef CHOPS_THREAD_POOL_H
+#define CHOPS_THREAD_POOL_H
+
+/*
+	A fixed size thread pool. Threads are started once and then
+	take tasks from a shared queue, so handing a piece of work to
+	another core costs a queue push instead of a thread creation.
+	submit returns a std::future, which is how callers wait for
+	their tasks and get exceptions thrown inside them.
+
+	work_stealing_pool is for divide and conquer work, where tasks
+	spawn more tasks and wait for them. Every worker has its own
+	deque: it pushes and pops at the back, so it keeps working on
+	the newest and smallest piece whose data is still in its cache,
+	and idle workers steal from the front of the others, which is
+	where the oldest and biggest pieces are. A thread that waits
+	in fork_join runs queued tasks in the meantime instead of
+	blocking, so nested waits can not starve the pool. The deques
+	are guarded by a mutex each, which only the owner and the
+	occasional thief ever contend for.
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+namespace chops{
+
+class thread_pool {
+
+	std::vector<std::thread> m_workers;
+	std::queue<std::function<void()>> m_tasks;
+	std::mutex m_mutex;
+	std::condition_variable m_cv;
+	bool m_stopping = false;
+
+	void work()
+	{
+		for(;;)
+		{
+			std::function<void()> task;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_cv.wait(lock, [this] { return m_stopping || !m_tasks.empty(); });
+				if(m_tasks.empty())
+					return; // stopping and nothing left to do
+				task = std::move(m_tasks.front());
+				m_tasks.pop();
+			}
+			task();
+		}
+	}
+
+	public:
+		// 0 threads means one per hardware thread
+		explicit thread_pool(unsigned threads = 0)
+		{
+			if(threads == 0)
+				threads = std::max(1u, std::thread::hardware_concurrency());
+			for(unsigned i = 0; i < threads; i++)
+				m_workers.emplace_back([this] { work(); });
+		}
+
+		thread_pool(const thread_pool&) = delete;
+		thread_pool& operator=(const thread_pool&) = delete;
+
+		// Finishes the queued tasks, then joins the threads
+		~thread_pool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_stopping = true;
+			}
+			m_cv.notify_all();
+			for(auto &w : m_workers)
+				w.join();
+		}
+
+		size_t size() const noexcept { return m_workers.size(); }
+
+		template <typename F>
+		std::future<void> submit(F f)
+		{
+			// std::function needs a copyable target, packaged_task is not
+			auto task = std::make_shared<std::packaged_task<void()>>(std::move(f));
+			std::future<void> result = task->get_future();
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_tasks.emplace([task] { (*task)(); });
+			}
+			m_cv.notify_one();
+			return result;
+		}
+};
+
+class work_stealing_pool {
+
+	struct task_queue {
+		std::mutex mutex;
+		std::deque<std::function<void()>> tasks;
+	};
+
+	std::vector<std::thread> m_workers;
+	// one per worker, and the last one for threads outside the pool
+	std::vector<std::unique_ptr<task_queue>> m_queues;
+	std::atomic<size_t> m_queued{0};
+	std::mutex m_sleep_mutex;
+	std::condition_variable m_sleep_cv;
+	bool m_stopping = false;
+
+	// the pool the calling thread is a worker of, and its queue there
+	static inline thread_local work_stealing_pool *t_pool = nullptr;
+	static inline thread_local size_t t_index = 0;
+
+	size_t own_queue() const noexcept
+	{
+		return t_pool == this ? t_index : m_workers.size();
+	}
+
+	void push(std::function<void()> task)
+	{
+		task_queue &queue = *m_queues[own_queue()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back(std::move(task));
+		}
+		m_queued++;
+		// a worker that just saw nothing queued is either still
+		// holding the sleep mutex or already waiting, never between
+		{
+			std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		}
+		m_sleep_cv.notify_one();
+	}
+
+	void work(size_t index)
+	{
+		t_pool = this;
+		t_index = index;
+		for(;;)
+		{
+			if(run_pending_task())
+				continue;
+			std::unique_lock<std::mutex> lock(m_sleep_mutex);
+			m_sleep_cv.wait(lock, [this] { return m_stopping || m_queued > 0; });
+			if(m_stopping && m_queued == 0)
+				return;
+		}
+	}
+
+	public:
+		// 0 threads means one per hardware thread
+		explicit work_stealing_pool(unsigned threads = 0)
+		{
+			if(threads == 0)
+				threads = std::max(1u, std::thread::hardware_concurrency());
+			for(unsigned i = 0; i <= threads; i++)
+				m_queues.push_back(std::make_unique<task_queue>());
+			for(unsigned i = 0; i < threads; i++)
+				m_workers.emplace_back([this, i] { work(i); });
+		}
+
+		work_stealing_pool(const work_stealing_pool&) = delete;
+		work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+
+		// Finishes the queued tasks, then joins the threads
+		~work_stealing_pool()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_sleep_mutex);
+				m_stopping = true;
+			}
+			m_sleep_cv.notify_all();
+			for(auto &w : m_workers)
+				w.join();
+		}
+
+		size_t size() const noexcept { return m_workers.size(); }
+
+		// Runs one queued task on the calling thread, its own queue's
+		// newest first, else the oldest of someone else's. Returns
+		// false if there was nothing to run.
+		bool run_pending_task()
+		{
+			size_t own = own_queue();
+			std::function<void()> task;
+			{
+				task_queue &queue = *m_queues[own];
+				std::lock_guard<std::mutex> lock(queue.mutex);
+				if(!queue.tasks.empty())
+				{
+					task = std::move(queue.tasks.back());
+					queue.tasks.pop_back();
+				}
+			}
+			for(size_t i = 1; !task && i < m_queues.size(); i++)
+			{
+				task_queue &victim = *m_queues[(own + i) % m_queues.size()];
+				std::lock_guard<std::mutex> lock(victim.mutex);
+				if(!victim.tasks.empty())
+				{
+					task = std::move(victim.tasks.front());
+					victim.tasks.pop_front();
+				}
+			}
+			if(!task)
+				return false;
+			m_queued--;
+			task();
+			return true;
+		}
+
+		template <typename F>
+		std::future<void> submit(F f)
+		{
+			auto task = std::make_shared<std::packaged_task<void()>>(std::move(f));
+			std::future<void> result = task->get_future();
+			push([task] { (*task)(); });
+			return result;
+		}
+
+		// Runs a on the calling thread and offers b to the pool, returns
+		// when both are done. Usually nobody steals b and we end up
+		// running it ourselves right after a. Works from any thread,
+		// one outside the pool helps like a worker while it waits.
+		// If a or b throws, the exception is rethrown here, a's first.
+		template <typename A, typename B>
+		void fork_join(A a, B b)
+		{
+			std::atomic<bool> b_done(false);
+			std::exception_ptr b_error;
+			push([&b, &b_done, &b_error] {
+				try { b(); }
+				catch(...) { b_error = std::current_exception(); }
+				b_done.store(true, std::memory_order_release);
+			});
+
+			std::exception_ptr a_error;
+			try { a(); }
+			catch(...) { a_error = std::current_exception(); }
+
+			// b lives on our stack, we can't leave before it is done
+			while(!b_done.load(std::memory_order_acquire))
+				if(!run_pending_task())
+					std::this_thread::yield();
+
+			if(a_error)
+				std::rethrow_exception(a_error);
+			if(b_error)
+				std::rethrow_exception(b_error);
+		}
+};
+
+// namespace chops ends
+}
+#endif
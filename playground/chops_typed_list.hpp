@@ -0,0 +1,274 @@
+#ifndef CHOPS_TYPED_LIST_H
+#define CHOPS_TYPED_LIST_H
+
+/*
+	This file contains the singly linked list of chops_singlylist
+	for any trivially copyable value type instead of just float.
+	The value is stored inline in the node, so typed_node<float>
+	has exactly the layout of node_t and there is no per node
+	overhead for being generic. Alignment of T is respected, even
+	for over-aligned types, since nodes come from operator new.
+
+	The functions have the same names and meaning as the list_t
+	ones, overloaded on typed_list<T>, so code moves from one to
+	the other by changing the types.
+
+	For C there is CHOPS_DECLARE_LIST at the bottom, which stamps
+	out a named node type, list type and the same functions for
+	one value type.
+*/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <functional>
+#include <type_traits>
+
+namespace chops{
+
+template <typename T>
+struct typed_node {
+	T value;
+	typed_node *next;
+};
+
+template <typename T>
+struct typed_list {
+	static_assert(std::is_trivially_copyable<T>::value,
+	              "typed_list stores values inline and copies them bitwise");
+
+	// the functions take values as value_type, so T is deduced from
+	// the list alone and push_back(doubles, 1.0f) just converts
+	using value_type = T;
+
+	typed_node<T> *head = nullptr;
+	typed_node<T> *tail = nullptr;
+	size_t length = 0;
+};
+
+template <typename T>
+typed_list<T>* make_list()
+{
+	return new typed_list<T>;
+}
+
+template <typename T>
+void destroy_list(typed_list<T> *list)
+{
+	typed_node<T> *cur = list->head;
+	while(cur != nullptr)
+	{
+		typed_node<T> *following = cur->next;
+		delete cur;
+		cur = following;
+	}
+	delete list;
+}
+
+// O(1) push front, "the real" singly list inserter
+template <typename T>
+void push_front(typed_list<T> *list, const typename typed_list<T>::value_type& val)
+{
+	typed_node<T> *node = new typed_node<T>{ val, list->head };
+	if(list->head == nullptr)
+		list->tail = node;
+	list->head = node;
+	list->length++;
+}
+
+template <typename T>
+void push_back(typed_list<T> *list, const typename typed_list<T>::value_type& val)
+{
+	typed_node<T> *node = new typed_node<T>{ val, nullptr };
+	if(list->head == nullptr)
+		list->head = node;
+	else
+		list->tail->next = node;
+	list->tail = node;
+	list->length++;
+}
+
+// Equal values keep insertion order, like push_sorted for list_t
+template <typename T, typename Compare = std::less<T>>
+void push_sorted(typed_list<T> *list, const typename typed_list<T>::value_type& val,
+                 Compare comp = Compare())
+{
+	typed_node<T> *before = nullptr;
+	typed_node<T> *cur = list->head;
+
+	while(cur != nullptr && !comp(val, cur->value))
+	{
+		before = cur;
+		cur = cur->next;
+	}
+
+	typed_node<T> *node = new typed_node<T>{ val, cur };
+	if(before == nullptr)
+		list->head = node;
+	else
+		before->next = node;
+	if(cur == nullptr)
+		list->tail = node;
+	list->length++;
+}
+
+template <typename T>
+size_t list_length(typed_list<T> *list)
+{
+	return list->length;
+}
+
+// Same structure sharing caveats as car and cdr of list_t
+template <typename T>
+typed_node<T>* car(typed_list<T> *list)
+{
+	return list->head;
+}
+
+template <typename T>
+typed_list<T>* cdr(typed_list<T> *list)
+{
+	typed_list<T> *tail = new typed_list<T>;
+	tail->head = list->head->next;
+	if(tail->head != nullptr)
+	{
+		tail->tail = list->tail;
+		tail->length = list->length - 1;
+	}
+	return tail;
+}
+
+template <typename T>
+typed_node<T>* next_node(typed_node<T> *cur)
+{
+	return cur->next;
+}
+
+// Takes function pointers like the list_t version, and any other
+// callable, which the compiler can then inline
+template <typename T, typename F>
+void map_each(typed_list<T> *list, F func)
+{
+	typed_node<T> *cur = list->head;
+	while(cur != nullptr)
+	{
+		func(cur);
+		cur = cur->next;
+	}
+}
+
+// namespace chops ends
+}
+
+/*
+	C version. CHOPS_DECLARE_LIST(dlist, double) declares dlist_node_t,
+	dlist_t and dlist_make, dlist_destroy, dlist_push_front,
+	dlist_push_back, dlist_push_sorted, dlist_length, dlist_car,
+	dlist_cdr and dlist_map_each. The type needs a working < for
+	push_sorted. Nodes come from calloc, so over-aligned types are not
+	supported here. dlist_cdr shares its nodes, like cdr of list_t, so
+	it is released with free, not dlist_destroy.
+*/
+#define CHOPS_DECLARE_LIST(name, type)                                              \
+typedef struct name##_node {                                                        \
+    type value;                                                                     \
+    struct name##_node *next;                                                       \
+}  name##_node_t ;                                                                  \
+                                                                                    \
+typedef struct name {                                                               \
+    name##_node_t *head;                                                            \
+    name##_node_t *tail;                                                            \
+    size_t length;                                                                  \
+}  name##_t ;                                                                       \
+                                                                                    \
+static inline name##_t* name##_make(void)                                           \
+{                                                                                   \
+    return (name##_t *) calloc(1, sizeof(name##_t));                                \
+}                                                                                   \
+                                                                                    \
+static inline void name##_destroy(name##_t *list)                                   \
+{                                                                                   \
+    name##_node_t *cur = list->head;                                                \
+    while(cur != NULL)                                                              \
+    {                                                                               \
+        name##_node_t *following = cur->next;                                       \
+        free(cur);                                                                  \
+        cur = following;                                                            \
+    }                                                                               \
+    free(list);                                                                     \
+}                                                                                   \
+                                                                                    \
+static inline name##_node_t* name##_new_node(type val, name##_node_t *next)         \
+{                                                                                   \
+    name##_node_t *node = (name##_node_t *) calloc(1, sizeof(name##_node_t));       \
+    node->value = val;                                                              \
+    node->next = next;                                                              \
+    return node;                                                                    \
+}                                                                                   \
+                                                                                    \
+static inline void name##_push_front(name##_t *list, type val)                      \
+{                                                                                   \
+    list->head = name##_new_node(val, list->head);                                  \
+    if(list->tail == NULL)                                                          \
+        list->tail = list->head;                                                    \
+    list->length++;                                                                 \
+}                                                                                   \
+                                                                                    \
+static inline void name##_push_back(name##_t *list, type val)                       \
+{                                                                                   \
+    name##_node_t *node = name##_new_node(val, NULL);                               \
+    if(list->head == NULL)                                                          \
+        list->head = node;                                                          \
+    else                                                                            \
+        list->tail->next = node;                                                    \
+    list->tail = node;                                                              \
+    list->length++;                                                                 \
+}                                                                                   \
+                                                                                    \
+static inline void name##_push_sorted(name##_t *list, type val)                     \
+{                                                                                   \
+    name##_node_t *before = NULL;                                                   \
+    name##_node_t *cur = list->head;                                                \
+    while(cur != NULL && !(val < cur->value))                                       \
+    {                                                                               \
+        before = cur;                                                               \
+        cur = cur->next;                                                            \
+    }                                                                               \
+    name##_node_t *node = name##_new_node(val, cur);                                \
+    if(before == NULL)                                                              \
+        list->head = node;                                                          \
+    else                                                                            \
+        before->next = node;                                                        \
+    if(cur == NULL)                                                                 \
+        list->tail = node;                                                          \
+    list->length++;                                                                 \
+}                                                                                   \
+                                                                                    \
+static inline size_t name##_length(name##_t *list)                                  \
+{                                                                                   \
+    return list->length;                                                            \
+}                                                                                   \
+                                                                                    \
+static inline name##_node_t* name##_car(name##_t *list)                             \
+{                                                                                   \
+    return list->head;                                                              \
+}                                                                                   \
+                                                                                    \
+static inline name##_t* name##_cdr(name##_t *list)                                  \
+{                                                                                   \
+    name##_t *tail = (name##_t *) calloc(1, sizeof(name##_t));                      \
+    tail->head = list->head->next;                                                  \
+    if(tail->head != NULL)                                                          \
+    {                                                                               \
+        tail->tail = list->tail;                                                    \
+        tail->length = list->length - 1;                                            \
+    }                                                                               \
+    return tail;                                                                    \
+}                                                                                   \
+                                                                                    \
+static inline void name##_map_each(name##_t *list, void (*func)(name##_node_t*))    \
+{                                                                                   \
+    for(name##_node_t *cur = list->head; cur != NULL; cur = cur->next)              \
+        func(cur);                                                                  \
+}
+
+#endif
@@ -0,0 +1,165 @@
+#ifndef CHOPS_UNROLLED_LIST_H
+#define CHOPS_UNROLLED_LIST_H
+
+/*
+    This file contains a C-style unrolled linked list of floats.
+    It is the same idea as chops_singlylist, but every node keeps
+    a small array of values instead of a single one. A node_t of
+    the plain list spends 16 bytes (8 of them for next, plus
+    padding) to store a 4 byte float, so a traversal pulls in
+    mostly pointers. Here a node is exactly one cache line, so a
+    traversal touches one line per ULIST_NODE_CAPACITY values
+    and the per value overhead is around 4 bytes.
+    https://www.wikiwand.com/en/Unrolled_linked_list
+*/
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <playground/chops_simd_map.hpp>
+
+#define ULIST_CACHE_LINE 64
+
+// what remains of a cache line after next and count
+#define ULIST_NODE_CAPACITY \
+    ((ULIST_CACHE_LINE - sizeof(void *) - sizeof(unsigned)) / sizeof(float))
+
+typedef struct unode {
+    struct unode *next;
+    unsigned count;
+    float values[ULIST_NODE_CAPACITY];
+}  unode_t ;
+
+typedef struct ulist {
+   unode_t *head;
+   unode_t *tail;
+   size_t length;
+}  ulist_t ;
+
+inline ulist_t* make_ulist()
+{
+	// calloc 0 initializes, so lists have a NULL
+	// head and tail at creation, and length 0
+	return (ulist_t *) calloc(1, sizeof(ulist_t));
+}
+
+inline void destroy_ulist(ulist_t *list)
+{
+	unode_t *cur = list->head;
+	while(cur != NULL)
+	{
+		unode_t *following = cur->next;
+		free(cur);
+		cur = following;
+	}
+	free(list);
+}
+
+// Values live at the front of the head node, so a push_front
+// shifts at most ULIST_NODE_CAPACITY floats, still O(1)
+inline void ulist_push_front(ulist_t *list, float val)
+{
+	unode_t *head = list->head;
+
+	if(head == NULL || head->count == ULIST_NODE_CAPACITY)
+	{
+		head = (unode_t *) calloc(1, sizeof(unode_t));
+		head->next = list->head;
+		list->head = head;
+		if(list->tail == NULL)
+			list->tail = head;
+	}
+	memmove(head->values + 1, head->values, head->count * sizeof(float));
+	head->values[0] = val;
+	head->count++;
+	list->length++;
+}
+
+inline void ulist_push_back(ulist_t *list, float val)
+{
+	unode_t *tail = list->tail;
+
+	if(tail == NULL || tail->count == ULIST_NODE_CAPACITY)
+	{
+		tail = (unode_t *) calloc(1, sizeof(unode_t));
+		if(list->tail == NULL)
+			list->head = tail;
+		else
+			list->tail->next = tail;
+		list->tail = tail;
+	}
+	tail->values[tail->count++] = val;
+	list->length++;
+}
+
+inline size_t ulist_length(ulist_t *list)
+{
+	return list->length;
+}
+
+// Traverse helpers work on values, since a node is no
+// longer a single element
+inline void double_value(float *v)
+{
+    *v *= 2;
+}
+
+inline void print_value(float *v)
+{
+    printf("%f ", *v);
+}
+
+inline void ulist_map_each(ulist_t *list, void (*func)(float*))
+{
+	unode_t *cur = list->head;
+    while(cur != NULL)
+    {
+        for(unsigned i = 0; i < cur->count; i++)
+            func(&cur->values[i]);
+        cur = cur->next;
+    }
+}
+
+// Bulk versions of map_each. Each node is handed to the SIMD
+// kernels as one block, so there is no call per value.
+inline void ulist_map_kernel(ulist_t *list, const kernel_t *k)
+{
+	unode_t *cur = list->head;
+    while(cur != NULL)
+    {
+        map_block(cur->values, cur->count, k);
+        cur = cur->next;
+    }
+}
+
+inline void ulist_scale(ulist_t *list, float a)
+{
+	kernel_t k = { KERNEL_SCALE, a, 0.0f };
+	ulist_map_kernel(list, &k);
+}
+
+inline void ulist_add(ulist_t *list, float a)
+{
+	kernel_t k = { KERNEL_ADD, a, 0.0f };
+	ulist_map_kernel(list, &k);
+}
+
+inline void ulist_fma(ulist_t *list, float a, float b)
+{
+	kernel_t k = { KERNEL_FMA, a, b };
+	ulist_map_kernel(list, &k);
+}
+
+inline void ulist_clamp(ulist_t *list, float lo, float hi)
+{
+	kernel_t k = { KERNEL_CLAMP, lo, hi };
+	ulist_map_kernel(list, &k);
+}
+
+inline void print_ulist(ulist_t *list)
+{
+	ulist_map_each(list, print_value);
+	printf("\n");
+}
+
+#endif
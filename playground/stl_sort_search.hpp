@@ -1,78 +1,901 @@
-/*
-	This file contains STL style implementations of basic searching
-	and sorting algorithms, using iterators. Most of these are, of
-	course, implemented better in STL. These are just for example
-	purposes.
-*/
-#include <iterator>
-#include <algorithm>
-#include <iostream>
-#include <type_traits>
-#include <cmath>
-
-// Alias template for iterators having floating types as value type
-// SFINAE for specializing on floating point types
-template <typename T>
-using floating_val_type = std::enable_if_t<std::is_floating_point<typename std::iterator_traits<T>::value_type>::value,
-										   typename std::iterator_traits<T>::value_type>;
-template <typename T>
-using nonfloating_val_type = std::enable_if_t<!std::is_floating_point<typename std::iterator_traits<T>::value_type>::value,
-											  typename std::iterator_traits<T>::value_type>;
-
-// If value_type of given Iterator is not a floating point type, this
-// template will be deduced
-template <typename ForwIt>
-ForwIt linear_search(ForwIt begin, ForwIt end,
-					 nonfloating_val_type<ForwIt> val)
-{
-	while (begin != end)
-	{
-		if (*begin != val)
-			begin++;
-		else
-			break;
-	}
-	return begin;
-}
-
-// If value_type of given Iterator is a floating point type, this
-// template will be deduced
-template <typename ForwIt>
-ForwIt linear_search(ForwIt begin, ForwIt end,
-					 floating_val_type<ForwIt> val)
-{
-	while (begin != end)
-	{
-		if (fabs(*begin - val) > 0.0001f)
-			begin++;
-		else
-			break;
-	}
-	return begin;
-}
-
-// We require insertion_sort to not invalidate iterators given as parameter
-// We require insertion_sort to be stable, but I won't test it
-template <typename BiderIt>
-void insertion_sort(BiderIt first, BiderIt last)
-{
-	BiderIt cur = first;
-	BiderIt limit = --last;
-	while (cur != limit)
-	{
-		cur++;
-		BiderIt inner = cur;
-		BiderIt left_of_inner = --cur;
-		while (inner != first && *left_of_inner > *inner)
-		{
-			std::iter_swap(left_of_inner, inner);
-			inner--;
-			if (left_of_inner == first)
-				break;
-			else
-				left_of_inner--;
-		}
-		cur++;
-	}
-}
-
+/*
+	This file contains STL style implementations of basic searching
+	and sorting algorithms, using iterators. Most of these are, of
+	course, implemented better in STL. These are just for example
+	purposes.
+*/
+#ifndef STL_SORT_SEARCH_H
+#define STL_SORT_SEARCH_H
+
+#include <iterator>
+#include <algorithm>
+#include <iostream>
+#include <type_traits>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <utility>
+#include <vector>
+#include <array>
+#include <cstring>
+#include <stdint.h>
+#include <playground/chops_prefetch.hpp>
+#include <playground/chops_sort_network.hpp>
+#include <playground/chops_thread_pool.hpp>
+
+// Alias template for iterators having floating types as value type
+// SFINAE for specializing on floating point types
+template <typename T>
+using floating_val_type = std::enable_if_t<std::is_floating_point<typename std::iterator_traits<T>::value_type>::value,
+										   typename std::iterator_traits<T>::value_type>;
+template <typename T>
+using nonfloating_val_type = std::enable_if_t<!std::is_floating_point<typename std::iterator_traits<T>::value_type>::value,
+											  typename std::iterator_traits<T>::value_type>;
+
+// How far apart two floating point values can be and still be
+// found by the searches below
+constexpr float search_tolerance = 0.0001f;
+
+// If value_type of given Iterator is not a floating point type, this
+// template will be deduced
+template <typename ForwIt>
+ForwIt linear_search(ForwIt begin, ForwIt end,
+					 nonfloating_val_type<ForwIt> val)
+{
+	while (begin != end)
+	{
+		if (*begin != val)
+			begin++;
+		else
+			break;
+	}
+	return begin;
+}
+
+// If value_type of given Iterator is a floating point type, this
+// template will be deduced
+template <typename ForwIt>
+ForwIt linear_search(ForwIt begin, ForwIt end,
+					 floating_val_type<ForwIt> val)
+{
+	while (begin != end)
+	{
+		if (fabs(*begin - val) > search_tolerance)
+			begin++;
+		else
+			break;
+	}
+	return begin;
+}
+
+// Binary searches over sorted random access ranges. The loop in
+// std::lower_bound branches on every comparison, and on random keys
+// half of those branches are mispredicted. Here the range only
+// shrinks from the top, n halves every step and the base moves up
+// or stays, which compiles to a conditional move. The loop always
+// runs log2(n) times, whatever the keys are.
+//
+// Without branches the CPU no longer runs ahead into the half it
+// guessed, so on arrays bigger than the cache we would wait for
+// every load. Instead both places the next step may look at are
+// prefetched, one of them is always right.
+//
+// Iterators must point to contiguous memory for the prefetches to
+// mean anything, but any random access iterator gives right results.
+template <typename RandIt, typename Pred>
+RandIt branchless_partition_point(RandIt first, RandIt last, Pred pred)
+{
+	auto n = last - first;
+	if (n == 0)
+		return first;
+
+	while (n > 1)
+	{
+		auto half = n / 2;
+		auto next_half = (n - half) / 2;
+		CHOPS_PREFETCH(&first[next_half]);
+		CHOPS_PREFETCH(&first[half + next_half]);
+		first += pred(first[half]) ? half : 0;
+		n -= half;
+	}
+	return first + pred(*first);
+}
+
+template <typename RandIt, typename T, typename Compare>
+RandIt branchless_lower_bound(RandIt first, RandIt last, const T &val, Compare comp)
+{
+	return branchless_partition_point(first, last,
+		[&](const auto &x) { return comp(x, val); });
+}
+
+template <typename RandIt, typename T, typename Compare>
+RandIt branchless_upper_bound(RandIt first, RandIt last, const T &val, Compare comp)
+{
+	return branchless_partition_point(first, last,
+		[&](const auto &x) { return !comp(val, x); });
+}
+
+template <typename RandIt, typename T, typename Compare>
+bool branchless_binary_search(RandIt first, RandIt last, const T &val, Compare comp)
+{
+	RandIt found = branchless_lower_bound(first, last, val, comp);
+	return found != last && !comp(val, *found);
+}
+
+// Without a comparator, values are compared like linear_search
+// does. Values that are not floating point must be equal to be found.
+template <typename RandIt>
+RandIt branchless_lower_bound(RandIt first, RandIt last,
+							  nonfloating_val_type<RandIt> val)
+{
+	return branchless_lower_bound(first, last, val, std::less<>());
+}
+
+template <typename RandIt>
+RandIt branchless_upper_bound(RandIt first, RandIt last,
+							  nonfloating_val_type<RandIt> val)
+{
+	return branchless_upper_bound(first, last, val, std::less<>());
+}
+
+template <typename RandIt>
+bool branchless_binary_search(RandIt first, RandIt last,
+							  nonfloating_val_type<RandIt> val)
+{
+	return branchless_binary_search(first, last, val, std::less<>());
+}
+
+// Floating point values are found if they are within
+// search_tolerance of val, and [lower_bound, upper_bound) holds all
+// of them.
+template <typename RandIt>
+RandIt branchless_lower_bound(RandIt first, RandIt last,
+							  floating_val_type<RandIt> val)
+{
+	return branchless_lower_bound(first, last, val - search_tolerance, std::less<>());
+}
+
+template <typename RandIt>
+RandIt branchless_upper_bound(RandIt first, RandIt last,
+							  floating_val_type<RandIt> val)
+{
+	return branchless_upper_bound(first, last, val + search_tolerance, std::less<>());
+}
+
+template <typename RandIt>
+bool branchless_binary_search(RandIt first, RandIt last,
+							  floating_val_type<RandIt> val)
+{
+	RandIt found = branchless_lower_bound(first, last, val);
+	return found != last && fabs(*found - val) <= search_tolerance;
+}
+
+// Moves *last left until the element before it is not greater.
+// Unguarded: there must be such an element somewhere before last,
+// nothing stops the walk at the beginning of the range.
+template <typename BiderIt, typename Compare>
+void unguarded_linear_insert(BiderIt last, Compare comp)
+{
+	auto val = std::move(*last);
+	BiderIt next = last;
+	--next;
+	while (comp(val, *next))
+	{
+		*last = std::move(*next);
+		last = next;
+		--next;
+	}
+	*last = std::move(val);
+}
+
+// Pointers and vector iterators, the contiguous iterators we can
+// recognize before C++20
+template <typename It, typename = void>
+struct is_vector_iterator : std::false_type {};
+template <typename It>
+struct is_vector_iterator<It, std::enable_if_t<
+	std::is_same<It, typename std::vector<typename std::iterator_traits<It>::value_type>::iterator>::value>>
+	: std::true_type {};
+
+// The arrays chops_sort_network sorts: float, int32_t and double in
+// contiguous memory, in ascending order
+template <typename It, typename Compare>
+using sort_network_applies = std::integral_constant<bool,
+	(std::is_same<typename std::iterator_traits<It>::value_type, float>::value ||
+	 std::is_same<typename std::iterator_traits<It>::value_type, int32_t>::value ||
+	 std::is_same<typename std::iterator_traits<It>::value_type, double>::value) &&
+	(std::is_same<Compare, std::less<>>::value ||
+	 std::is_same<Compare, std::less<typename std::iterator_traits<It>::value_type>>::value) &&
+	(std::is_pointer<It>::value || is_vector_iterator<It>::value)>;
+
+inline int sort_network(float *v, size_t n) { return sort_network_float(v, n); }
+inline int sort_network(int32_t *v, size_t n) { return sort_network_int32(v, n); }
+inline int sort_network(double *v, size_t n) { return sort_network_double(v, n); }
+
+// The networks are not stable. Equal int32_t values can't be told
+// apart and the networks refuse NaN, so only -0.0 and 0.0 could
+// notice. Floating point ranges with a zero are left to the stable
+// sorts then.
+template <typename T>
+bool sort_network_keeps_order(const T *v, size_t n)
+{
+	if (!std::is_floating_point<T>::value || n < SORT_NETWORK_MIN || n > SORT_NETWORK_MAX)
+		return true;
+	for (size_t i = 0; i < n; i++)
+		if (v[i] == 0)
+			return false;
+	return true;
+}
+
+// Returns whether a sorting network did the job
+template <typename It, typename Compare>
+std::enable_if_t<sort_network_applies<It, Compare>::value, bool>
+try_sort_network(It first, It last, Compare)
+{
+	auto *v = &*first;
+	size_t n = (size_t) (last - first);
+	return sort_network_keeps_order(v, n) && sort_network(v, n) != 0;
+}
+
+template <typename It, typename Compare>
+std::enable_if_t<!sort_network_applies<It, Compare>::value, bool>
+try_sort_network(It, It, Compare)
+{
+	return false;
+}
+
+// We require insertion_sort to not invalidate iterators given as parameter
+// We require insertion_sort to be stable, but I won't test it
+// Elements are moved out once and every greater one is shifted
+// right with a single move, instead of being swapped with it.
+// Contiguous float, int32_t and double ranges of 8 to 64 values
+// in ascending order go to a SIMD sorting network instead, unless
+// they hold a zero, see sort_network_keeps_order.
+template <typename BiderIt, typename Compare = std::less<>>
+void insertion_sort(BiderIt first, BiderIt last, Compare comp = Compare())
+{
+	if (first == last || try_sort_network(first, last, comp))
+		return;
+	for (BiderIt cur = std::next(first); cur != last; ++cur)
+	{
+		BiderIt prev = std::prev(cur);
+		if (!comp(*cur, *prev))
+			continue;
+		auto val = std::move(*cur);
+		BiderIt hole = cur;
+		do
+		{
+			*hole = std::move(*prev);
+			hole = prev;
+		} while (hole != first && comp(val, *--prev));
+		*hole = std::move(val);
+	}
+}
+
+// insertion_sort without the check for the beginning of the range,
+// for ranges that have an element not greater than any of theirs
+// right before first, like the partitions of a quicksort
+template <typename BiderIt, typename Compare = std::less<>>
+void unguarded_insertion_sort(BiderIt first, BiderIt last, Compare comp = Compare())
+{
+	for (BiderIt cur = first; cur != last; ++cur)
+		unguarded_linear_insert(cur, comp);
+}
+
+// Finds the place of each element with a binary search, so only
+// O(n log n) comparisons, then shifts the greater ones right as a
+// block with a single move each. Pays off when comparisons are
+// expensive, like for strings, the number of moves is the same
+// as for insertion_sort. Stable, since equal elements are passed.
+template <typename RandIt, typename Compare = std::less<>>
+void binary_insertion_sort(RandIt first, RandIt last, Compare comp = Compare())
+{
+	if (first == last)
+		return;
+	for (RandIt cur = first + 1; cur != last; ++cur)
+	{
+		if (!comp(*cur, *(cur - 1)))
+			continue;
+		// we know *(cur - 1) is greater, no need to look at it again
+		RandIt pos = std::upper_bound(first, cur - 1, *cur, comp);
+		auto val = std::move(*cur);
+		std::move_backward(pos, cur, cur + 1);
+		*pos = std::move(val);
+	}
+}
+
+/*
+	Pattern-defeating quicksort, Orson Peters' pdqsort. It is an
+	introsort at heart: quicksort with median of 3 pivots, ninthers
+	for big partitions, insertion_sort for small ones, and heapsort
+	once too many partitions came out badly unbalanced, so it stays
+	O(n log n). On top of that it
+	- shuffles a few elements after a bad partition, which breaks
+	  the patterns that make the pivot choice fail again,
+	- notices when a partition needed no swaps and tries to finish
+	  it with a bounded insertion sort, so sorted and almost sorted
+	  inputs take linear time,
+	- puts elements equal to the pivot of the parent partition to
+	  the left in one go, so many duplicates are linear too,
+	- for arithmetic types and the standard comparators, partitions
+	  in blocks: comparison results are stored as offsets first and
+	  swapped afterwards, so there is no branch on the comparison
+	  to mispredict.
+	Not stable.
+*/
+constexpr std::ptrdiff_t pdq_insertion_threshold = 24;
+constexpr std::ptrdiff_t pdq_ninther_threshold = 128;
+constexpr std::ptrdiff_t pdq_partial_insertion_limit = 8;
+constexpr std::ptrdiff_t pdq_block_size = 64;
+
+template <typename RandIt, typename Compare>
+void pdq_sort2(RandIt a, RandIt b, Compare comp)
+{
+	if (comp(*b, *a))
+		std::iter_swap(a, b);
+}
+
+// Afterwards *a <= *b <= *c
+template <typename RandIt, typename Compare>
+void pdq_sort3(RandIt a, RandIt b, RandIt c, Compare comp)
+{
+	pdq_sort2(a, b, comp);
+	pdq_sort2(b, c, comp);
+	pdq_sort2(a, b, comp);
+}
+
+// insertion_sort that gives up after pdq_partial_insertion_limit
+// moves, returns whether the range got sorted
+template <typename RandIt, typename Compare>
+bool pdq_partial_insertion_sort(RandIt first, RandIt last, Compare comp)
+{
+	if (first == last)
+		return true;
+	std::ptrdiff_t moves = 0;
+	for (RandIt cur = first + 1; cur != last; ++cur)
+	{
+		if (!comp(*cur, *(cur - 1)))
+			continue;
+		auto val = std::move(*cur);
+		RandIt hole = cur;
+		do
+		{
+			*hole = std::move(*(hole - 1));
+			--hole;
+		} while (hole != first && comp(val, *(hole - 1)));
+		*hole = std::move(val);
+		moves += cur - hole;
+		if (moves > pdq_partial_insertion_limit)
+			return false;
+	}
+	return true;
+}
+
+// Partitions around *first, elements equal to it go right. Needs an
+// element not less than the pivot at the end, which pdq_sort3 puts
+// there. Returns the final pivot position and whether no element
+// had to be swapped.
+template <typename RandIt, typename Compare>
+std::pair<RandIt, bool> pdq_partition_right(RandIt first, RandIt last, Compare comp)
+{
+	auto pivot = std::move(*first);
+	RandIt left = first;
+	RandIt right = last;
+
+	while (comp(*++left, pivot));
+	// if nothing was less there may be nothing to stop the walk left
+	if (left - 1 == first)
+		while (left < right && !comp(*--right, pivot));
+	else
+		while (!comp(*--right, pivot));
+
+	bool already_partitioned = left >= right;
+	while (left < right)
+	{
+		std::iter_swap(left, right);
+		while (comp(*++left, pivot));
+		while (!comp(*--right, pivot));
+	}
+
+	RandIt pivot_pos = left - 1;
+	*first = std::move(*pivot_pos);
+	*pivot_pos = std::move(pivot);
+	return std::make_pair(pivot_pos, already_partitioned);
+}
+
+// pdq_partition_right with the inner loops done in blocks, after
+// Edelkamp and Weiss' BlockQuicksort
+template <typename RandIt, typename Compare>
+std::pair<RandIt, bool> pdq_partition_right_blocks(RandIt first, RandIt last, Compare comp)
+{
+	auto pivot = std::move(*first);
+	RandIt left = first;
+	RandIt right = last;
+
+	while (comp(*++left, pivot));
+	if (left - 1 == first)
+		while (left < right && !comp(*--right, pivot));
+	else
+		while (!comp(*--right, pivot));
+
+	bool already_partitioned = left >= right;
+	if (!already_partitioned)
+	{
+		std::iter_swap(left, right);
+		++left;
+
+		// offsets of the elements on the wrong side, per block
+		unsigned char offsets_l[pdq_block_size];
+		unsigned char offsets_r[pdq_block_size];
+		RandIt base_l = left;
+		RandIt base_r = right;
+		std::ptrdiff_t num_l = 0, num_r = 0, start_l = 0, start_r = 0;
+
+		while (left < right)
+		{
+			// fill whichever side ran out, split what is left when it is small
+			std::ptrdiff_t unknown = right - left;
+			std::ptrdiff_t split_l = num_l == 0 ? (num_r == 0 ? unknown / 2 : unknown) : 0;
+			std::ptrdiff_t split_r = num_r == 0 ? unknown - split_l : 0;
+			if (split_l > pdq_block_size)
+				split_l = pdq_block_size;
+			if (split_r > pdq_block_size)
+				split_r = pdq_block_size;
+
+			// the offset is always written, it only counts if the
+			// element belongs on the other side
+			for (std::ptrdiff_t i = 0; i < split_l; i++)
+			{
+				offsets_l[num_l] = (unsigned char) i;
+				num_l += !comp(*left, pivot);
+				++left;
+			}
+			for (std::ptrdiff_t i = 0; i < split_r;)
+			{
+				offsets_r[num_r] = (unsigned char) ++i;
+				num_r += comp(*--right, pivot);
+			}
+
+			std::ptrdiff_t num = std::min(num_l, num_r);
+			for (std::ptrdiff_t i = 0; i < num; i++)
+				std::iter_swap(base_l + offsets_l[start_l + i], base_r - offsets_r[start_r + i]);
+			num_l -= num;
+			num_r -= num;
+			start_l += num;
+			start_r += num;
+			if (num_l == 0)
+			{
+				start_l = 0;
+				base_l = left;
+			}
+			if (num_r == 0)
+			{
+				start_r = 0;
+				base_r = right;
+			}
+		}
+
+		// one side may still have misplaced elements, the range between
+		// left and right is gone so they go next to the other side
+		if (num_l)
+		{
+			while (num_l--)
+				std::iter_swap(base_l + offsets_l[start_l + num_l], --right);
+			left = right;
+		}
+		if (num_r)
+		{
+			while (num_r--)
+				std::iter_swap(base_r - offsets_r[start_r + num_r], left++);
+			right = left;
+		}
+	}
+
+	RandIt pivot_pos = left - 1;
+	*first = std::move(*pivot_pos);
+	*pivot_pos = std::move(pivot);
+	return std::make_pair(pivot_pos, already_partitioned);
+}
+
+// Partitions around *first with equal elements going left. Used when
+// the pivot equals the element before first, then every element equal
+// to it is done and only the right part needs more work.
+template <typename RandIt, typename Compare>
+RandIt pdq_partition_left(RandIt first, RandIt last, Compare comp)
+{
+	auto pivot = std::move(*first);
+	RandIt left = first;
+	RandIt right = last;
+
+	while (comp(pivot, *--right));
+	if (right + 1 == last)
+		while (left < right && !comp(pivot, *++left));
+	else
+		while (!comp(pivot, *++left));
+
+	while (left < right)
+	{
+		std::iter_swap(left, right);
+		while (comp(pivot, *--right));
+		while (!comp(pivot, *++left));
+	}
+
+	*first = std::move(*right);
+	*right = std::move(pivot);
+	return right;
+}
+
+template <typename RandIt, typename Compare, bool Blocks>
+void pdq_sort_loop(RandIt first, RandIt last, Compare comp, int bad_allowed, bool leftmost)
+{
+	while (true)
+	{
+		std::ptrdiff_t size = last - first;
+		if (size < pdq_insertion_threshold)
+		{
+			if (leftmost)
+				insertion_sort(first, last, comp);
+			else
+				unguarded_insertion_sort(first, last, comp);
+			return;
+		}
+
+		// the pivot ends up in *first, with a greater or equal element at the end
+		std::ptrdiff_t half = size / 2;
+		if (size > pdq_ninther_threshold)
+		{
+			pdq_sort3(first, first + half, last - 1, comp);
+			pdq_sort3(first + 1, first + (half - 1), last - 2, comp);
+			pdq_sort3(first + 2, first + (half + 1), last - 3, comp);
+			pdq_sort3(first + (half - 1), first + half, first + (half + 1), comp);
+			std::iter_swap(first, first + half);
+		}
+		else
+			pdq_sort3(first + half, first, last - 1, comp);
+
+		// the parent pivot is right before us, if ours equals it,
+		// everything equal goes left and is done
+		if (!leftmost && !comp(*(first - 1), *first))
+		{
+			first = pdq_partition_left(first, last, comp) + 1;
+			continue;
+		}
+
+		std::pair<RandIt, bool> part = Blocks ? pdq_partition_right_blocks(first, last, comp)
+		                                      : pdq_partition_right(first, last, comp);
+		RandIt pivot_pos = part.first;
+		std::ptrdiff_t l_size = pivot_pos - first;
+		std::ptrdiff_t r_size = last - (pivot_pos + 1);
+
+		if (l_size < size / 8 || r_size < size / 8)
+		{
+			if (--bad_allowed == 0)
+			{
+				std::make_heap(first, last, comp);
+				std::sort_heap(first, last, comp);
+				return;
+			}
+			// break up whatever pattern fooled the pivot choice
+			if (l_size >= pdq_insertion_threshold)
+			{
+				std::iter_swap(first, first + l_size / 4);
+				std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+				if (l_size > pdq_ninther_threshold)
+				{
+					std::iter_swap(first + 1, first + (l_size / 4 + 1));
+					std::iter_swap(first + 2, first + (l_size / 4 + 2));
+					std::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+					std::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+				}
+			}
+			if (r_size >= pdq_insertion_threshold)
+			{
+				std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+				std::iter_swap(last - 1, last - r_size / 4);
+				if (r_size > pdq_ninther_threshold)
+				{
+					std::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+					std::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+					std::iter_swap(last - 2, last - (1 + r_size / 4));
+					std::iter_swap(last - 3, last - (2 + r_size / 4));
+				}
+			}
+		}
+		else if (part.second && pdq_partial_insertion_sort(first, pivot_pos, comp)
+		                     && pdq_partial_insertion_sort(pivot_pos + 1, last, comp))
+			return;
+
+		// recurse into the left part, loop on the right one
+		pdq_sort_loop<RandIt, Compare, Blocks>(first, pivot_pos, comp, bad_allowed, leftmost);
+		first = pivot_pos + 1;
+		leftmost = false;
+	}
+}
+
+// Block partitioning only pays off when a comparison is a single
+// instruction, so it is used for arithmetic types under the
+// standard comparators
+template <typename RandIt, typename Compare>
+using pdq_use_blocks = std::integral_constant<bool,
+	std::is_arithmetic<typename std::iterator_traits<RandIt>::value_type>::value &&
+	(std::is_same<Compare, std::less<>>::value ||
+	 std::is_same<Compare, std::greater<>>::value ||
+	 std::is_same<Compare, std::less<typename std::iterator_traits<RandIt>::value_type>>::value ||
+	 std::is_same<Compare, std::greater<typename std::iterator_traits<RandIt>::value_type>>::value)>;
+
+// O(n log n) worst case, O(n) for sorted, reversed or all equal input
+template <typename RandIt, typename Compare = std::less<>>
+void pdqsort(RandIt first, RandIt last, Compare comp = Compare())
+{
+	std::ptrdiff_t size = last - first;
+	if (size < 2)
+		return;
+	int log2 = 0;
+	while (size >>= 1)
+		log2++;
+	pdq_sort_loop<RandIt, Compare, pdq_use_blocks<RandIt, Compare>::value>(first, last, comp, log2, true);
+}
+
+/*
+	Stable parallel merge sort. The range is split in halves down to
+	parallel_sort_grain elements, and the halves are sorted as tasks
+	of a work_stealing_pool. Below that the recursion goes on in the
+	same thread down to leaves of merge_sort_leaf elements, which
+	insertion_sort handles. The merges are parallel too: the middle
+	element of the longer run is looked up in the other run with a
+	binary search, which splits the merge into two independent ones.
+
+	There is a single scratch buffer as long as the range. The data
+	moves into it at the start, and every level merges from one of
+	the two arrays into the other, so no level copies back.
+*/
+constexpr std::ptrdiff_t merge_sort_leaf = 32;
+constexpr std::ptrdiff_t parallel_sort_grain = 1 << 14;
+
+// Stable merge of [first1, last1) and [first2, last2) into out,
+// ties are taken from the first run
+template <typename RandIt, typename OutIt, typename Compare>
+void parallel_merge(chops::work_stealing_pool &pool, RandIt first1, RandIt last1,
+					RandIt first2, RandIt last2, OutIt out, Compare comp)
+{
+	std::ptrdiff_t len1 = last1 - first1;
+	std::ptrdiff_t len2 = last2 - first2;
+	if (len1 + len2 <= parallel_sort_grain)
+	{
+		std::merge(std::make_move_iterator(first1), std::make_move_iterator(last1),
+				   std::make_move_iterator(first2), std::make_move_iterator(last2), out, comp);
+		return;
+	}
+
+	RandIt mid1, mid2;
+	if (len1 >= len2)
+	{
+		// equal elements of the second run have to end up after mid1
+		mid1 = first1 + len1 / 2;
+		mid2 = std::lower_bound(first2, last2, *mid1, comp);
+	}
+	else
+	{
+		// and equal elements of the first run before mid2
+		mid2 = first2 + len2 / 2;
+		mid1 = std::upper_bound(first1, last1, *mid2, comp);
+	}
+	OutIt out_mid = out + ((mid1 - first1) + (mid2 - first2));
+	pool.fork_join(
+		[&] { parallel_merge(pool, first1, mid1, first2, mid2, out, comp); },
+		[&] { parallel_merge(pool, mid1, last1, mid2, last2, out_mid, comp); });
+}
+
+// Sorts the elements in [first, last), leaving them there if to_other
+// is false, or in the same positions of the range starting at other
+// if it is true. The rest of other is scratch space.
+template <typename RandIt, typename OtherIt, typename Compare>
+void merge_sort_into(chops::work_stealing_pool &pool, RandIt first, RandIt last,
+					 OtherIt other, bool to_other, Compare comp)
+{
+	std::ptrdiff_t size = last - first;
+	if (size <= merge_sort_leaf)
+	{
+		insertion_sort(first, last, comp);
+		if (to_other)
+			std::move(first, last, other);
+		return;
+	}
+
+	// the halves go to the array we do not merge into
+	std::ptrdiff_t half = size / 2;
+	auto sort_left = [&] { merge_sort_into(pool, first, first + half, other, !to_other, comp); };
+	auto sort_right = [&] { merge_sort_into(pool, first + half, last, other + half, !to_other, comp); };
+	if (size > parallel_sort_grain)
+		pool.fork_join(sort_left, sort_right);
+	else
+	{
+		sort_left();
+		sort_right();
+	}
+
+	if (to_other)
+		parallel_merge(pool, first, first + half, first + half, last, other, comp);
+	else
+		parallel_merge(pool, other, other + half, other + half, other + size, first, comp);
+}
+
+template <typename RandIt, typename Compare = std::less<>>
+void parallel_merge_sort(chops::work_stealing_pool &pool, RandIt first, RandIt last,
+						 Compare comp = Compare())
+{
+	using value_type = typename std::iterator_traits<RandIt>::value_type;
+	if (last - first < 2)
+		return;
+	std::vector<value_type> buffer(std::make_move_iterator(first), std::make_move_iterator(last));
+	merge_sort_into(pool, buffer.begin(), buffer.end(), first, true, comp);
+}
+
+// One pool for every call that does not bring its own
+inline chops::work_stealing_pool& default_sort_pool()
+{
+	static chops::work_stealing_pool pool;
+	return pool;
+}
+
+// O(n log n), stable, n extra space
+template <typename RandIt, typename Compare = std::less<>>
+void parallel_merge_sort(RandIt first, RandIt last, Compare comp = Compare())
+{
+	parallel_merge_sort(default_sort_pool(), first, last, comp);
+}
+
+/*
+	LSD radix sort for integer and floating point keys. Keys are
+	turned into unsigned integers that sort in the same order, then
+	the elements are distributed by one byte of that at a time, the
+	least significant first. Every pass is stable, so after the
+	last one the range is sorted by the whole key, in O(n) per byte
+	instead of O(n log n) comparisons.
+
+	The histograms of every pass are counted up front in a single
+	read of the range, split over the pool for big ranges. A pass
+	whose byte is the same for every element is skipped, so small
+	keys in wide types cost only as many passes as they need.
+
+	key picks the sort key out of an element, by default the element
+	itself, so records can be sorted by one of their fields. Stable.
+	Unlike a comparison sort, -0.0 goes before 0.0 and NaNs go to
+	the ends according to their sign bit.
+*/
+constexpr std::ptrdiff_t radix_parallel_grain = 1 << 16;
+
+template <std::size_t Bytes> struct radix_unsigned;
+template <> struct radix_unsigned<1> { using type = uint8_t; };
+template <> struct radix_unsigned<2> { using type = uint16_t; };
+template <> struct radix_unsigned<4> { using type = uint32_t; };
+template <> struct radix_unsigned<8> { using type = uint64_t; };
+
+template <typename T>
+using radix_bits_t = typename radix_unsigned<sizeof(T)>::type;
+
+// As with linear_search, the floating point versions are picked by
+// floating_val_type. KeyPtr is a pointer to the key type.
+
+// Signed integers get their sign bit flipped, so negatives come first
+template <typename KeyPtr>
+radix_bits_t<nonfloating_val_type<KeyPtr>> radix_key(nonfloating_val_type<KeyPtr> key)
+{
+	using T = nonfloating_val_type<KeyPtr>;
+	using U = radix_bits_t<T>;
+	static_assert(std::is_integral<T>::value, "radix_sort keys must be integers or floating point");
+	U bits = (U) key;
+	if (std::is_signed<T>::value)
+		bits ^= (U) ((U) 1 << (sizeof(U) * 8 - 1));
+	return bits;
+}
+
+// Positive floats order like their bits once the sign bit is set.
+// Negative ones get every bit flipped, so that larger magnitudes
+// come first and -0.0 lands right before 0.0.
+template <typename KeyPtr>
+radix_bits_t<floating_val_type<KeyPtr>> radix_key(floating_val_type<KeyPtr> key)
+{
+	using U = radix_bits_t<floating_val_type<KeyPtr>>;
+	U bits;
+	std::memcpy(&bits, &key, sizeof(bits));
+	const U sign = (U) 1 << (sizeof(U) * 8 - 1);
+	return (bits & sign) ? (U) ~bits : (U) (bits | sign);
+}
+
+struct radix_identity {
+	template <typename T>
+	const T& operator()(const T &x) const noexcept { return x; }
+};
+
+using radix_counts = std::vector<std::array<std::size_t, 256>>;
+
+// Byte histograms of every pass over [first, first + n)
+template <typename RandIt, typename Key>
+void radix_histogram(chops::work_stealing_pool &pool, RandIt first, std::ptrdiff_t n,
+					 Key &key, radix_counts &counts)
+{
+	using key_type = std::decay_t<decltype(key(*first))>;
+	if (n > radix_parallel_grain)
+	{
+		radix_counts right(counts.size(), std::array<std::size_t, 256>{});
+		pool.fork_join(
+			[&] { radix_histogram(pool, first, n / 2, key, counts); },
+			[&] { radix_histogram(pool, first + n / 2, n - n / 2, key, right); });
+		for (std::size_t pass = 0; pass < counts.size(); pass++)
+			for (std::size_t b = 0; b < 256; b++)
+				counts[pass][b] += right[pass][b];
+		return;
+	}
+	for (RandIt cur = first; cur != first + n; ++cur)
+	{
+		auto bits = radix_key<const key_type *>(key(*cur));
+		for (std::size_t pass = 0; pass < counts.size(); pass++)
+			counts[pass][(bits >> (8 * pass)) & 0xFF]++;
+	}
+}
+
+// One stable distribution pass, by byte pass of the key
+template <typename InIt, typename OutIt, typename Key>
+void radix_scatter(InIt first, std::ptrdiff_t n, OutIt out, std::size_t pass,
+				   const std::array<std::size_t, 256> &count, Key &key)
+{
+	using key_type = std::decay_t<decltype(key(*first))>;
+	std::array<std::size_t, 256> offset;
+	std::size_t sum = 0;
+	for (std::size_t b = 0; b < 256; b++)
+	{
+		offset[b] = sum;
+		sum += count[b];
+	}
+	for (InIt cur = first; cur != first + n; ++cur)
+	{
+		auto bits = radix_key<const key_type *>(key(*cur));
+		out[offset[(bits >> (8 * pass)) & 0xFF]++] = std::move(*cur);
+	}
+}
+
+template <typename RandIt, typename Key = radix_identity>
+void radix_sort(chops::work_stealing_pool &pool, RandIt first, RandIt last, Key key = Key())
+{
+	static_assert(std::is_same<typename std::iterator_traits<RandIt>::iterator_category,
+							   std::random_access_iterator_tag>::value,
+				  "radix_sort needs random access iterators");
+	using value_type = typename std::iterator_traits<RandIt>::value_type;
+	using key_type = std::decay_t<decltype(key(*first))>;
+
+	std::ptrdiff_t n = last - first;
+	if (n < 2)
+		return;
+
+	radix_counts counts(sizeof(key_type), std::array<std::size_t, 256>{});
+	radix_histogram(pool, first, n, key, counts);
+	auto first_bits = radix_key<const key_type *>(key(*first));
+
+	std::vector<value_type> buffer;
+	bool in_buffer = false;
+	for (std::size_t pass = 0; pass < sizeof(key_type); pass++)
+	{
+		// every element has the same byte here, nothing would move
+		if (counts[pass][(first_bits >> (8 * pass)) & 0xFF] == (std::size_t) n)
+			continue;
+		if (buffer.empty())
+			buffer.resize(n);
+		if (in_buffer)
+			radix_scatter(buffer.begin(), n, first, pass, counts[pass], key);
+		else
+			radix_scatter(first, n, buffer.begin(), pass, counts[pass], key);
+		in_buffer = !in_buffer;
+	}
+	if (in_buffer)
+		std::move(buffer.begin(), buffer.end(), first);
+}
+
+// O(n * sizeof(key)), stable, n extra space
+template <typename RandIt, typename Key = radix_identity>
+void radix_sort(RandIt first, RandIt last, Key key = Key())
+{
+	radix_sort(default_sort_pool(), first, last, key);
+}
+
+#endif
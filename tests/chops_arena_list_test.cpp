@@ -0,0 +1,143 @@
+#include <playground/chops_arena_list.hpp>
+#include <playground/chops_singlylist.hpp>
+#include <catch.hpp>
+#include <vector>
+
+static std::vector<float> to_vector(alist_t *list)
+{
+    std::vector<float> out;
+    for(anode_t *cur = alist_car(list); cur != NULL; cur = alist_next(list, cur))
+        out.push_back(cur->value);
+    return out;
+}
+
+TEST_CASE("An arena list node is half a node_t", "[arena_list]") {
+    REQUIRE(sizeof(anode_t) == 8);
+    if(sizeof(void *) == 8)
+        REQUIRE(sizeof(node_t) == 2 * sizeof(anode_t));
+}
+
+TEST_CASE("An arena list", "[arena_list]") {
+
+    SECTION("can be created, and initially is empty") {
+        alist_t *test_list = make_alist();
+        REQUIRE(alist_car(test_list) == NULL);
+        REQUIRE(alist_length(test_list) == 0);
+        destroy_alist(test_list);
+    }
+
+    SECTION("supports the same inserts as list_t across arena growth") {
+        alist_t *test_list = make_alist();
+        list_t *expected = make_list();
+
+        for(int i = 0; i < 100; i++)
+        {
+            float v = (float) ((i * 37) % 101);
+            if(i % 3 == 0)
+            {
+                alist_push_front(test_list, v);
+                push_front(expected, v);
+            }
+            else
+            {
+                alist_push_back(test_list, v);
+                push_back(expected, v);
+            }
+        }
+
+        std::vector<float> want;
+        for(node_t *cur = expected->head; cur != NULL; cur = next_node(cur))
+            want.push_back(cur->value);
+        REQUIRE(to_vector(test_list) == want);
+        REQUIRE(alist_length(test_list) == 100);
+        REQUIRE(test_list->capacity >= 101);
+
+        destroy_list(expected);
+        destroy_alist(test_list);
+    }
+
+    SECTION("keeps sorted order with alist_push_sorted") {
+        alist_t *test_list = make_alist();
+        alist_push_sorted(test_list, 7.0f);
+        alist_push_sorted(test_list, 2.0f);
+        alist_push_sorted(test_list, 13.0f);
+        alist_push_sorted(test_list, 4.0f);
+
+        REQUIRE(to_vector(test_list) == std::vector<float>{ 2.0f, 4.0f, 7.0f, 13.0f });
+        REQUIRE(alist_node(test_list, test_list->tail)->value == Approx(13.0f));
+        destroy_alist(test_list);
+    }
+
+    SECTION("grows up to the last index 32 bits can reach") {
+        REQUIRE(alist_grown_capacity(16) == 32);
+        REQUIRE(alist_grown_capacity(1u << 31) == UINT32_MAX);
+        REQUIRE(alist_grown_capacity((1u << 31) + 5) == UINT32_MAX);
+        REQUIRE(alist_grown_capacity(UINT32_MAX) == UINT32_MAX);
+    }
+
+    SECTION("refuses pushes once every index is taken") {
+        alist_t *test_list = make_alist();
+        REQUIRE(alist_push_back(test_list, 1.0f) == 0);
+
+        // pretend the arena is full, nothing is read or written then
+        uint32_t used = test_list->used;
+        uint32_t capacity = test_list->capacity;
+        test_list->used = UINT32_MAX;
+        test_list->capacity = UINT32_MAX;
+        REQUIRE(alist_push_back(test_list, 2.0f) == -1);
+        REQUIRE(alist_push_front(test_list, 2.0f) == -1);
+        REQUIRE(alist_push_sorted(test_list, 2.0f) == -1);
+        test_list->used = used;
+        test_list->capacity = capacity;
+
+        REQUIRE(alist_length(test_list) == 1);
+        REQUIRE(to_vector(test_list) == std::vector<float>{ 1.0f });
+        destroy_alist(test_list);
+    }
+
+    SECTION("can be transformed using alist_map_each") {
+        alist_t *test_list = make_alist();
+        alist_push_back(test_list, 2.0f);
+        alist_push_back(test_list, 4.0f);
+        alist_map_each(test_list, double_anode);
+        REQUIRE(to_vector(test_list) == std::vector<float>{ 4.0f, 8.0f });
+        destroy_alist(test_list);
+    }
+}
+
+static float sum;
+static void sum_node(node_t *n) { sum += n->value; }
+static void sum_anode(anode_t *n) { sum += n->value; }
+
+TEST_CASE("Arena list against list_t", "[.][benchmark][arena_list]") {
+    const int n = 4000000;
+    list_t *plain = make_list();
+    alist_t *arena = make_alist();
+
+    BENCHMARK("list_t push_back, 4M nodes") {
+        for(int i = 0; i < n; i++)
+            push_back(plain, (float) i);
+    }
+
+    BENCHMARK("alist_t push_back, 4M nodes") {
+        for(int i = 0; i < n; i++)
+            alist_push_back(arena, (float) i);
+    }
+
+    BENCHMARK("list_t map_each, 4M nodes") {
+        map_each(plain, sum_node);
+    }
+
+    BENCHMARK("alist_t map_each, 4M nodes") {
+        alist_map_each(arena, sum_anode);
+    }
+
+    WARN("list_t node bytes: " << sizeof(node_t) << " (plus malloc header per node), "
+         "alist_t node bytes: " << sizeof(anode_t) << ", arena total: "
+         << arena->capacity * sizeof(anode_t) / (1024 * 1024) << " MiB for "
+         << alist_length(arena) << " nodes");
+
+    destroy_alist(arena);
+    destroy_list(plain);
+    REQUIRE(sum > 0.0f);
+}
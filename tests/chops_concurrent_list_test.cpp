@@ -0,0 +1,104 @@
+#include <playground/chops_concurrent_list.hpp>
+#include <catch.hpp>
+#include <thread>
+#include <string>
+#include <algorithm>
+#include <vector>
+
+// Runs producers pushing items_each values each, and consumers
+// popping until everything has been popped. Returns how many
+// times each value was seen.
+static std::vector<int> run_producers_consumers(concurrent_list_t *list,
+                                                int producers, int consumers,
+                                                int items_each)
+{
+    const int total = producers * items_each;
+    std::vector<std::atomic<int>> seen(total);
+    std::atomic<int> popped(0);
+    std::vector<std::thread> threads;
+
+    for(auto &s : seen)
+        s.store(0);
+
+    for(int p = 0; p < producers; p++)
+        threads.emplace_back([=] {
+            for(int i = 0; i < items_each; i++)
+                concurrent_push_front(list, (float) (p * items_each + i));
+        });
+
+    for(int c = 0; c < consumers; c++)
+        threads.emplace_back([&] {
+            float val;
+            while(popped.load() < total)
+                if(concurrent_pop_front(list, &val))
+                {
+                    seen[(int) val]++;
+                    popped++;
+                }
+        });
+
+    for(auto &t : threads)
+        t.join();
+
+    std::vector<int> counts;
+    for(auto &s : seen)
+        counts.push_back(s.load());
+    return counts;
+}
+
+TEST_CASE("A concurrent singly linked list", "[concurrent_list_t]") {
+
+    SECTION("is a stack when used from one thread") {
+        concurrent_list_t *test_list = make_concurrent_list();
+        float val = 0.0f;
+
+        REQUIRE(concurrent_pop_front(test_list, &val) == 0);
+
+        concurrent_push_front(test_list, 2.0f);
+        concurrent_push_front(test_list, 4.0f);
+        concurrent_push_front(test_list, 7.0f);
+
+        REQUIRE(concurrent_pop_front(test_list, &val) == 1);
+        REQUIRE(val == Approx(7.0f));
+        REQUIRE(concurrent_pop_front(test_list, &val) == 1);
+        REQUIRE(val == Approx(4.0f));
+
+        SECTION("and reuses the nodes it popped") {
+            cnode_t *spare = tagged_node(test_list->spare.load());
+            concurrent_push_front(test_list, 8.0f);
+            REQUIRE(tagged_node(test_list->head.load()) == spare);
+        }
+
+        REQUIRE(concurrent_pop_front(test_list, &val) == 1);
+        REQUIRE(concurrent_pop_front(test_list, &val) == 1);
+        REQUIRE(val == Approx(2.0f));
+        REQUIRE(concurrent_pop_front(test_list, &val) == 0);
+        destroy_concurrent_list(test_list);
+    }
+
+    SECTION("hands every pushed value to exactly one consumer") {
+        concurrent_list_t *test_list = make_concurrent_list();
+        std::vector<int> seen = run_producers_consumers(test_list, 4, 4, 20000);
+        for(size_t i = 0; i < seen.size(); i++)
+            REQUIRE(seen[i] == 1);
+        destroy_concurrent_list(test_list);
+    }
+}
+
+TEST_CASE("Concurrent list throughput", "[.][benchmark][concurrent_list_t]") {
+    const int items = 1000000;
+    const int max_threads = (int) std::max(2u, std::thread::hardware_concurrency());
+
+    for(int threads = 2; threads <= max_threads; threads *= 2)
+    {
+        concurrent_list_t *test_list = make_concurrent_list();
+        const int each_side = threads / 2;
+        std::string name = std::to_string(each_side) + " producers / " +
+                           std::to_string(each_side) + " consumers, " +
+                           std::to_string(items) + " items";
+        BENCHMARK(name) {
+            run_producers_consumers(test_list, each_side, each_side, items / each_side);
+        }
+        destroy_concurrent_list(test_list);
+    }
+}
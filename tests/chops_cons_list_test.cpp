@@ -0,0 +1,72 @@
+#include <playground/chops_cons_list.hpp>
+#include <catch.hpp>
+
+TEST_CASE("A persistent cons list", "[cons_t]") {
+
+    SECTION("is NULL when empty") {
+        cons_t *empty = NULL;
+        REQUIRE(cons_length(empty) == 0);
+        cons_release(empty);
+    }
+
+    SECTION("is built by consing in front, and car/cdr take it apart") {
+        cons_t *list = cons(2.0f, NULL);
+        cons_t *longer = cons(4.0f, list);
+        cons_release(list); // longer keeps it alive
+
+        REQUIRE(cons_length(longer) == 2);
+        REQUIRE(cons_car(longer) == Approx(4.0f));
+        REQUIRE(cons_car(cons_cdr(longer)) == Approx(2.0f));
+        REQUIRE(cons_cdr(cons_cdr(longer)) == NULL);
+        cons_release(longer);
+    }
+
+    SECTION("shares tails between versions") {
+        cons_t *base = cons(7.0f, NULL);
+        cons_t *a = cons(1.0f, base);
+        cons_t *b = cons(2.0f, base);
+
+        REQUIRE(cons_cdr(a) == cons_cdr(b));
+        REQUIRE(base->refs == 3);
+
+        SECTION("and the shared tail outlives the lists in any order") {
+            cons_release(base);
+            cons_release(a);
+            REQUIRE(base->refs == 1);
+            REQUIRE(cons_car(cons_cdr(b)) == Approx(7.0f));
+            cons_release(b);
+        }
+
+        SECTION("and a retained cdr outlives its list") {
+            cons_t *tail = cons_retain(cons_cdr(a));
+            cons_release(a);
+            cons_release(b);
+            cons_release(base);
+            REQUIRE(tail->refs == 1);
+            REQUIRE(cons_car(tail) == Approx(7.0f));
+            cons_release(tail);
+        }
+    }
+
+    SECTION("can keep thousands of versions sharing one tail") {
+        const int n = 5000;
+        cons_t *versions[n];
+        cons_t *list = NULL;
+
+        for(int i = 0; i < n; i++)
+        {
+            cons_t *next = cons((float) i, list);
+            cons_release(list);
+            list = next;
+            versions[i] = cons_retain(list);
+        }
+        cons_release(list);
+
+        REQUIRE(cons_length(versions[n - 1]) == n);
+        REQUIRE(cons_cdr(versions[n - 1]) == versions[n - 2]);
+        REQUIRE(versions[0]->refs == 2);
+
+        for(int i = 0; i < n; i++)
+            cons_release(versions[i]);
+    }
+}
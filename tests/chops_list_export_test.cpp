@@ -0,0 +1,116 @@
+#include <playground/chops_list_export.hpp>
+#include <catch.hpp>
+#include "list_test_helpers.hpp"
+#include <string>
+#include <vector>
+
+static std::string read_all(FILE *file)
+{
+    std::string out;
+    char chunk[4096];
+    size_t n;
+    rewind(file);
+    while((n = fread(chunk, 1, sizeof(chunk), file)) > 0)
+        out.append(chunk, n);
+    return out;
+}
+
+static std::vector<float> parse_text(const std::string &text)
+{
+    std::vector<float> out;
+    const char *p = text.c_str();
+    char *end;
+    for(float v = strtof(p, &end); end != p; v = strtof(p, &end))
+    {
+        out.push_back(v);
+        p = end;
+    }
+    return out;
+}
+
+TEST_CASE("A list_t can be exported", "[list_export]") {
+    list_t *test_list = make_list();
+    push_back(test_list, 2.0f);
+    push_back(test_list, -0.1f);
+    push_back(test_list, 1e-38f);
+    push_back(test_list, 3.4028235e38f);
+    push_back(test_list, 1.0f / 3.0f);
+
+    // a tiny buffer forces many flushes
+    list_exporter_t *exporter = make_list_exporter(40);
+    FILE *file = tmpfile();
+    REQUIRE(file != NULL);
+
+    SECTION("as shortest round trip text") {
+        REQUIRE(export_list(exporter, test_list, file, EXPORT_TEXT) == 0);
+        std::string text = read_all(file);
+        REQUIRE(text.substr(0, 7) == "2 -0.1 ");
+        REQUIRE(text.back() == '\n');
+        REQUIRE(parse_text(text) == to_vector(test_list));
+    }
+
+    SECTION("as raw binary floats") {
+        REQUIRE(export_list(exporter, test_list, file, EXPORT_BINARY) == 0);
+        std::string bytes = read_all(file);
+        REQUIRE(bytes.size() == 5 * sizeof(float));
+        std::vector<float> values(5);
+        memcpy(values.data(), bytes.data(), bytes.size());
+        REQUIRE(values == to_vector(test_list));
+    }
+
+    SECTION("to a file descriptor") {
+        REQUIRE(export_list_fd(exporter, test_list, fileno(file), EXPORT_TEXT) == 0);
+        REQUIRE(parse_text(read_all(file)) == to_vector(test_list));
+    }
+
+    SECTION("and an empty list is just a newline") {
+        list_t *empty = make_list();
+        REQUIRE(export_list(exporter, empty, file, EXPORT_TEXT) == 0);
+        REQUIRE(read_all(file) == "\n");
+        destroy_list(empty);
+    }
+
+    SECTION("and a failing write is reported") {
+        REQUIRE(export_list_fd(exporter, test_list, -1, EXPORT_TEXT) == -1);
+    }
+
+    fclose(file);
+    destroy_list_exporter(exporter);
+    destroy_list(test_list);
+}
+
+static FILE *bench_file;
+static void fprint_node(node_t *n)
+{
+    fprintf(bench_file, "%f ", n->value);
+}
+
+TEST_CASE("print_list style output against export_list", "[.][benchmark][list_export]") {
+    list_t *test_list = make_list();
+    for(int i = 0; i < 1000000; i++)
+        push_back(test_list, (float) i / 7.0f);
+    bench_file = tmpfile();
+    list_exporter_t *exporter = make_list_exporter(EXPORT_DEFAULT_BUFFER);
+
+    BENCHMARK("fprintf per node, 1M nodes") {
+        rewind(bench_file);
+        map_each(test_list, fprint_node);
+        fflush(bench_file);
+    }
+
+    BENCHMARK("export_list text, 1M nodes") {
+        rewind(bench_file);
+        export_list(exporter, test_list, bench_file, EXPORT_TEXT);
+        fflush(bench_file);
+    }
+
+    BENCHMARK("export_list binary, 1M nodes") {
+        rewind(bench_file);
+        export_list(exporter, test_list, bench_file, EXPORT_BINARY);
+        fflush(bench_file);
+    }
+
+    destroy_list_exporter(exporter);
+    fclose(bench_file);
+    destroy_list(test_list);
+}
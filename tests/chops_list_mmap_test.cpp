@@ -0,0 +1,233 @@
+#include <playground/chops_list_mmap.hpp>
+#include <playground/chops_list_export.hpp>
+#include <catch.hpp>
+#include "list_test_helpers.hpp"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+static std::vector<float> to_vector(alist_t *list)
+{
+    std::vector<float> out;
+    for(anode_t *cur = alist_car(list); cur != NULL; cur = alist_next(list, cur))
+        out.push_back(cur->value);
+    return out;
+}
+
+TEST_CASE("A list can be saved and used from a mapping", "[list_mmap]") {
+    const char *path = "chops_list_mmap_test.bin";
+    list_t *test_list = make_list();
+    for(int i = 0; i < 10000; i++)
+        push_back(test_list, (float) i / 4);
+    std::vector<float> expected = to_vector(test_list);
+
+    REQUIRE(list_save(test_list, path) == 0);
+
+    SECTION("and traversed in place") {
+        mapped_list_t *mapped = list_map(path);
+        REQUIRE(mapped != NULL);
+        REQUIRE(alist_length(mapped->list) == 10000);
+        REQUIRE(to_vector(mapped->list) == expected);
+        REQUIRE(alist_node(mapped->list, mapped->list->tail)->value == Approx(9999.0f / 4));
+        list_unmap(mapped);
+    }
+
+    SECTION("and modified without touching the file") {
+        mapped_list_t *mapped = list_map(path);
+        alist_map_each(mapped->list, double_anode);
+        REQUIRE(alist_car(mapped->list)->value == Approx(0.0f));
+        REQUIRE(alist_next(mapped->list, alist_car(mapped->list))->value == Approx(0.5f));
+
+        // past the end of the mapping, the arena moves to the heap
+        anode_t *first = alist_car(mapped->list);
+        alist_push_front(mapped->list, -1.0f);
+        alist_push_back(mapped->list, 1.0f);
+        REQUIRE(mapped->list->borrowed == 0);
+        REQUIRE(alist_car(mapped->list) != first);
+        REQUIRE(alist_length(mapped->list) == 10002);
+        REQUIRE(to_vector(mapped->list).front() == Approx(-1.0f));
+        REQUIRE(to_vector(mapped->list).back() == Approx(1.0f));
+
+        mapped_list_t *again = list_map(path);
+        REQUIRE(to_vector(again->list) == expected);
+        list_unmap(again);
+
+        SECTION("unless it is saved again") {
+            REQUIRE(alist_save(mapped->list, path) == 0);
+            again = list_map(path);
+            REQUIRE(to_vector(again->list) == to_vector(mapped->list));
+            list_unmap(again);
+        }
+        list_unmap(mapped);
+    }
+
+    SECTION("or loaded back into a list_t") {
+        list_t *loaded = list_load(path);
+        REQUIRE(loaded != NULL);
+        REQUIRE(to_vector(loaded) == expected);
+        REQUIRE(list_length(loaded) == 10000);
+        REQUIRE(loaded->block_nodes == 10000);
+        destroy_list(loaded);
+    }
+
+    destroy_list(test_list);
+    remove(path);
+}
+
+TEST_CASE("An arena saves with its links as they are", "[list_mmap]") {
+    const char *path = "chops_list_mmap_test.bin";
+
+    SECTION("out of order links") {
+        alist_t *arena = make_alist();
+        for(float v : { 5.0f, 1.0f, 3.0f, 2.0f, 4.0f })
+            alist_push_sorted(arena, v);
+        REQUIRE(alist_save(arena, path) == 0);
+
+        mapped_list_t *mapped = list_map(path);
+        REQUIRE(to_vector(mapped->list) == to_vector(arena));
+        REQUIRE(mapped->list->head == arena->head);
+        REQUIRE(mapped->list->tail == arena->tail);
+        list_unmap(mapped);
+        destroy_alist(arena);
+    }
+
+    SECTION("an empty list") {
+        list_t *empty = make_list();
+        REQUIRE(list_save(empty, path) == 0);
+        mapped_list_t *mapped = list_map(path);
+        REQUIRE(mapped != NULL);
+        REQUIRE(alist_car(mapped->list) == NULL);
+        alist_push_back(mapped->list, 7.0f);
+        REQUIRE(alist_car(mapped->list)->value == Approx(7.0f));
+        list_unmap(mapped);
+        destroy_list(empty);
+    }
+
+    SECTION("files that are not lists are refused") {
+        REQUIRE(list_map("no/such/file.bin") == NULL);
+
+        FILE *file = fopen(path, "wb");
+        fputs("CHOPSLST but not really", file);
+        fclose(file);
+        REQUIRE(list_map(path) == NULL);
+        REQUIRE(list_load(path) == NULL);
+    }
+
+    remove(path);
+}
+
+// Overwrites size bytes at offset in the file
+static void patch_file(const char *path, long offset, const void *bytes, size_t size)
+{
+    FILE *file = fopen(path, "r+b");
+    fseek(file, offset, SEEK_SET);
+    fwrite(bytes, size, 1, file);
+    fclose(file);
+}
+
+TEST_CASE("Corrupt list files are caught", "[list_mmap]") {
+    const char *path = "chops_list_mmap_test.bin";
+    const float values[] = { 1.0f, 2.0f, 3.0f, 4.0f };
+    list_t *test_list = list_from_array(values, 4);
+    REQUIRE(list_save(test_list, path) == 0);
+    destroy_list(test_list);
+
+    // node i is slot i, after the header
+    const long first_link = sizeof(list_file_header_t) + sizeof(anode_t) +
+                            offsetof(anode_t, next);
+
+    SECTION("a length the arena can't hold") {
+        for(uint64_t length : { (uint64_t) 5, (uint64_t) 1 << 40, UINT64_MAX })
+        {
+            patch_file(path, offsetof(list_file_header_t, length), &length, sizeof(length));
+            REQUIRE(list_map(path) == NULL);
+            REQUIRE(list_load(path) == NULL);
+        }
+    }
+
+    SECTION("a length that doesn't match the links") {
+        uint64_t length = 3;
+        patch_file(path, offsetof(list_file_header_t, length), &length, sizeof(length));
+        mapped_list_t *mapped = list_map(path);
+        REQUIRE(mapped != NULL);
+        REQUIRE_FALSE(alist_links_valid(mapped->list));
+        list_unmap(mapped);
+        REQUIRE(list_load(path) == NULL);
+    }
+
+    SECTION("a link out of the arena") {
+        uint32_t link = 0xfffffff0u;
+        patch_file(path, first_link, &link, sizeof(link));
+        mapped_list_t *mapped = list_map(path);
+        REQUIRE(mapped != NULL);
+        REQUIRE_FALSE(alist_links_valid(mapped->list));
+        list_unmap(mapped);
+        REQUIRE(list_load(path) == NULL);
+    }
+
+    SECTION("a link back to an earlier node") {
+        uint32_t link = 1;
+        patch_file(path, first_link + 2 * sizeof(anode_t), &link, sizeof(link));
+        REQUIRE(list_load(path) == NULL);
+    }
+
+    SECTION("but not a file that is fine") {
+        mapped_list_t *mapped = list_map(path);
+        REQUIRE(alist_links_valid(mapped->list));
+        list_unmap(mapped);
+        list_t *loaded = list_load(path);
+        REQUIRE(to_vector(loaded) == std::vector<float>{ 1.0f, 2.0f, 3.0f, 4.0f });
+        destroy_list(loaded);
+    }
+
+    remove(path);
+}
+
+TEST_CASE("Reloading a list of 10M floats", "[.][benchmark][list_mmap]") {
+    const char *raw_path = "chops_list_mmap_bench.raw";
+    const char *path = "chops_list_mmap_bench.bin";
+    const size_t n = 10000000;
+    list_t *test_list = make_list();
+    for(size_t i = 0; i < n; i++)
+        push_back(test_list, (float) (i % 1000));
+
+    // how we did it before, raw floats rebuilt with push_back
+    FILE *raw = fopen(raw_path, "wb");
+    list_exporter_t *exporter = make_list_exporter(EXPORT_DEFAULT_BUFFER);
+    export_list(exporter, test_list, raw, EXPORT_BINARY);
+    destroy_list_exporter(exporter);
+    fclose(raw);
+    list_save(test_list, path);
+    destroy_list(test_list);
+
+    BENCHMARK("fread and push_back") {
+        list_t *list = make_list();
+        float chunk[4096];
+        size_t got;
+        FILE *file = fopen(raw_path, "rb");
+        while((got = fread(chunk, sizeof(float), 4096, file)) > 0)
+            for(size_t i = 0; i < got; i++)
+                push_back(list, chunk[i]);
+        fclose(file);
+        destroy_list(list);
+    }
+
+    BENCHMARK("list_load") {
+        destroy_list(list_load(path));
+    }
+
+    BENCHMARK("list_map") {
+        list_unmap(list_map(path));
+    }
+
+    static float sum;
+    BENCHMARK("list_map and a full traversal") {
+        mapped_list_t *mapped = list_map(path);
+        sum = 0;
+        alist_map_each(mapped->list, [](anode_t *node) { sum += node->value; });
+        list_unmap(mapped);
+    }
+
+    remove(raw_path);
+    remove(path);
+}
@@ -0,0 +1,100 @@
+#include <playground/chops_list_pipeline.hpp>
+#include <catch.hpp>
+#include <functional>
+#include <vector>
+
+static float times_two(float v) { return v * 2; }
+static float plus_one(float v) { return v + 1; }
+static int above_ten(float v) { return v > 10; }
+static float add(float a, float b) { return a + b; }
+
+static void plus_one_node(node_t *n) { n->value += 1; }
+static void clamp_node(node_t *n) { if(n->value <= 10) n->value = 0; }
+
+TEST_CASE("A list_t pipeline", "[list_pipeline]") {
+    const float values[] = { 2.0f, 4.0f, 7.0f, 7.0f, 8.0f, 12.0f };
+    list_t *test_list = list_from_array(values, 6);
+
+    SECTION("is lazy until a terminal operation runs") {
+        int calls = 0;
+        auto p = chops::from(test_list).map([&](float v) { calls++; return v * 2; });
+        REQUIRE(calls == 0);
+        REQUIRE(p.count() == 6);
+        REQUIRE(calls == 6);
+    }
+
+    SECTION("fuses map, filter and reduce into one pass") {
+        float sum = chops::from(test_list)
+            .map([](float v) { return v * 2; })
+            .filter([](float v) { return v > 10; })
+            .map([](float v) { return v + 1; })
+            .reduce(0.0f, std::plus<float>());
+        // 14, 14, 16, 24 survive the filter
+        REQUIRE(sum == Approx(15.0f + 15.0f + 17.0f + 25.0f));
+    }
+
+    SECTION("visits values in list order") {
+        std::vector<float> seen;
+        chops::from(test_list)
+            .filter([](float v) { return v != 7.0f; })
+            .for_each([&](float v) { seen.push_back(v); });
+        REQUIRE(seen == std::vector<float>{ 2.0f, 4.0f, 8.0f, 12.0f });
+    }
+
+    SECTION("can be collected into a new list, leaving the source alone") {
+        list_t *out = chops::from(test_list).map(times_two).filter(above_ten).collect();
+        REQUIRE(list_length(out) == 4);
+        REQUIRE(out->head->value == Approx(14.0f));
+        REQUIRE(out->tail->value == Approx(24.0f));
+        REQUIRE(test_list->head->value == Approx(2.0f));
+        destroy_list(out);
+    }
+
+    SECTION("has a C version built from stage_t descriptors") {
+        const stage_t stages[] = {
+            { STAGE_MAP, times_two, NULL },
+            { STAGE_FILTER, NULL, above_ten },
+            { STAGE_MAP, plus_one, NULL },
+        };
+        REQUIRE(list_pipeline_reduce(test_list, stages, 3, add, 0.0f) == Approx(72.0f));
+
+        list_t *out = list_pipeline_collect(test_list, stages, 3);
+        REQUIRE(list_length(out) == 4);
+        REQUIRE(out->head->value == Approx(15.0f));
+        destroy_list(out);
+    }
+
+    destroy_list(test_list);
+}
+
+TEST_CASE("Three map_each passes against one fused pipeline", "[.][benchmark][list_pipeline]") {
+    const size_t n = 4000000;
+    std::vector<float> values(n);
+    for(size_t i = 0; i < n; i++)
+        values[i] = (float) (i % 100);
+
+    list_t *test_list = make_list();
+    for(size_t i = 0; i < n; i++)
+        push_front(test_list, values[i]);
+
+    BENCHMARK("map_each x3 then a reduction pass") {
+        map_each(test_list, double_node);
+        map_each(test_list, plus_one_node);
+        map_each(test_list, clamp_node);
+        float sum = 0.0f;
+        for(node_t *cur = test_list->head; cur != NULL; cur = cur->next)
+            sum += cur->value;
+        REQUIRE(sum > 0.0f);
+    }
+
+    BENCHMARK("fused pipeline") {
+        float sum = chops::from(test_list)
+            .map([](float v) { return v * 2; })
+            .map([](float v) { return v + 1; })
+            .filter([](float v) { return v > 10; })
+            .reduce(0.0f, std::plus<float>());
+        REQUIRE(sum > 0.0f);
+    }
+
+    destroy_list(test_list);
+}
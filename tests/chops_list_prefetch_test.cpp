@@ -0,0 +1,74 @@
+#include <playground/chops_list_prefetch.hpp>
+#include <catch.hpp>
+#include "list_test_helpers.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+static float sum;
+static void sum_node(node_t *n)
+{
+    sum += n->value;
+}
+
+TEST_CASE("Prefetching traversals", "[list_prefetch]") {
+
+    SECTION("map_each_prefetch visits nodes like map_each") {
+        list_t *expected = make_scattered_list(1000, 1);
+        list_t *actual = make_scattered_list(1000, 1);
+        map_each(expected, double_node);
+        map_each_prefetch(actual, double_node);
+        REQUIRE(to_vector(actual) == to_vector(expected));
+        destroy_list(expected);
+        destroy_list_prefetch(actual);
+    }
+
+    SECTION("a jump index visits nodes in list order") {
+        for(size_t n : { (size_t) 0, (size_t) 5, (size_t) 1000 })
+        {
+            list_t *expected = make_scattered_list(n, 2);
+            list_t *actual = make_scattered_list(n, 2);
+            jump_index_t *index = make_jump_index(actual);
+
+            REQUIRE(index->count == n);
+            map_each(expected, double_node);
+            map_each_jump(index, double_node);
+            REQUIRE(to_vector(actual) == to_vector(expected));
+
+            destroy_jump_index(index);
+            destroy_list(expected);
+            destroy_list_prefetch(actual);
+        }
+    }
+
+    SECTION("destroy_list_prefetch handles bulk nodes") {
+        const float values[] = { 1.0f, 2.0f, 3.0f };
+        list_t *test_list = list_from_array(values, 3);
+        push_back(test_list, 4.0f);
+        destroy_list_prefetch(test_list);
+    }
+}
+
+TEST_CASE("Traversing a list larger than the last level cache", "[.][benchmark][list_prefetch]") {
+    list_t *test_list = make_scattered_list(8000000, 3);
+    jump_index_t *index = make_jump_index(test_list);
+
+    BENCHMARK("map_each, 8M scattered nodes") {
+        map_each(test_list, sum_node);
+    }
+
+    BENCHMARK("map_each_prefetch, 8M scattered nodes") {
+        map_each_prefetch(test_list, sum_node);
+    }
+
+    BENCHMARK("map_each_jump, 8M scattered nodes") {
+        map_each_jump(index, sum_node);
+    }
+
+    destroy_jump_index(index);
+
+    BENCHMARK("destroy_list_prefetch, 8M scattered nodes") {
+        destroy_list_prefetch(test_list);
+    }
+    REQUIRE(sum > 0.0f);
+}
@@ -0,0 +1,238 @@
+#include <playground/chops_list_sort.hpp>
+#include <catch.hpp>
+#include <algorithm>
+#include <vector>
+
+// Deterministic pseudo random floats in [0, 100), coarse enough
+// to have plenty of duplicates for the stability checks
+static float next_value(unsigned &state)
+{
+    state = state * 1103515245u + 12345u;
+    return (float) ((state >> 8) % 1000) / 10.0f;
+}
+
+// Nodes remember their insertion index in the order they were
+// allocated, so stability can be checked by address
+static void require_sorted_and_stable(list_t *list, const std::vector<node_t *> &order)
+{
+    size_t count = 0;
+    node_t *last = NULL;
+    for(node_t *cur = list->head; cur != NULL; cur = next_node(cur), count++)
+    {
+        if(last != NULL)
+        {
+            REQUIRE(last->value <= cur->value);
+            if(last->value == cur->value)
+            {
+                auto li = std::find(order.begin(), order.end(), last);
+                auto ci = std::find(order.begin(), order.end(), cur);
+                REQUIRE(li < ci);
+            }
+        }
+        last = cur;
+    }
+    REQUIRE(count == list_length(list));
+    REQUIRE(last == list->tail);
+}
+
+TEST_CASE("A list_t can be merge sorted in place", "[list_sort]") {
+
+    SECTION("empty and single node lists are left alone") {
+        list_t *test_list = make_list();
+        list_sort(test_list);
+        REQUIRE(test_list->head == NULL);
+
+        push_back(test_list, 3.0f);
+        list_sort(test_list);
+        REQUIRE(test_list->head->value == Approx(3.0f));
+        REQUIRE(test_list->head == test_list->tail);
+        destroy_list(test_list);
+    }
+
+    SECTION("by relinking the nodes it already has, stably") {
+        list_t *test_list = make_list();
+        std::vector<node_t *> order;
+        unsigned state = 1;
+
+        for(int i = 0; i < 1000; i++)
+        {
+            push_back(test_list, next_value(state));
+            order.push_back(test_list->tail);
+        }
+
+        list_sort(test_list);
+        require_sorted_and_stable(test_list, order);
+        destroy_list(test_list);
+    }
+
+    SECTION("or with several threads") {
+        for(unsigned threads : { 2u, 3u, 4u, 7u })
+        {
+            list_t *test_list = make_list();
+            std::vector<node_t *> order;
+            unsigned state = threads;
+
+            for(int i = 0; i < 1001; i++)
+            {
+                push_back(test_list, next_value(state));
+                order.push_back(test_list->tail);
+            }
+
+            list_sort_parallel(test_list, threads);
+            require_sorted_and_stable(test_list, order);
+            destroy_list(test_list);
+        }
+    }
+}
+
+// k lists of about n / k sorted values each. order gets the nodes
+// list after list, which is the order a stable merge keeps ties in.
+static std::vector<list_t *> make_sorted_lists(size_t k, size_t n, unsigned state,
+                                               std::vector<node_t *> &order)
+{
+    std::vector<list_t *> lists;
+    for(size_t i = 0; i < k; i++)
+    {
+        std::vector<float> values;
+        for(size_t j = 0; j < n / k + i % 3; j++)
+            values.push_back(next_value(state));
+        std::sort(values.begin(), values.end());
+        // every other list is one block, the rest are malloced nodes
+        list_t *list = i % 2 ? list_from_array(values.data(), values.size()) : make_list();
+        if(i % 2 == 0)
+            for(float v : values)
+                push_back(list, v);
+        for(node_t *cur = list->head; cur != NULL; cur = next_node(cur))
+            order.push_back(cur);
+        lists.push_back(list);
+    }
+    return lists;
+}
+
+static void require_merged(std::vector<list_t *> &lists, const std::vector<node_t *> &order)
+{
+    require_sorted_and_stable(lists[0], order);
+    REQUIRE(list_length(lists[0]) == order.size());
+    for(size_t i = 1; i < lists.size(); i++)
+    {
+        REQUIRE(lists[i]->head == NULL);
+        REQUIRE(list_length(lists[i]) == 0);
+    }
+    for(list_t *list : lists)
+        destroy_list(list);
+}
+
+TEST_CASE("Sorted list_ts can be merged k ways", "[list_sort]") {
+
+    SECTION("two at a time") {
+        std::vector<node_t *> order;
+        auto lists = make_sorted_lists(2, 200, 5, order);
+        list_merge(lists[0], lists[1]);
+        require_merged(lists, order);
+    }
+
+    SECTION("with a loser tree") {
+        for(size_t k : { 1, 2, 3, 8, 13 })
+        {
+            std::vector<node_t *> order;
+            auto lists = make_sorted_lists(k, 500, (unsigned) k, order);
+            list_merge_k(lists.data(), k);
+            require_merged(lists, order);
+        }
+    }
+
+    SECTION("including empty lists") {
+        std::vector<node_t *> order;
+        auto lists = make_sorted_lists(4, 100, 9, order);
+        lists.insert(lists.begin(), make_list());
+        lists.insert(lists.begin() + 3, make_list());
+        lists.push_back(make_list());
+        list_merge_k(lists.data(), lists.size());
+        require_merged(lists, order);
+    }
+
+    SECTION("or only empty lists") {
+        std::vector<list_t *> lists = { make_list(), make_list(), make_list() };
+        list_merge_k(lists.data(), lists.size());
+        REQUIRE(lists[0]->head == NULL);
+        REQUIRE(lists[0]->tail == NULL);
+        push_back(lists[0], 1.0f);
+        REQUIRE(lists[0]->head == lists[0]->tail);
+        std::vector<node_t *> order = { lists[0]->head };
+        require_merged(lists, order);
+    }
+
+    SECTION("in rounds when there are more lists than the tree holds") {
+        std::vector<node_t *> order;
+        auto lists = make_sorted_lists(LIST_MERGE_K_TREE * 2 + 5, 2000, 11, order);
+        list_merge_k(lists.data(), lists.size());
+        require_merged(lists, order);
+    }
+
+    SECTION("or with several threads") {
+        for(unsigned threads : { 2u, 3u, 4u, 7u })
+        {
+            std::vector<node_t *> order;
+            auto lists = make_sorted_lists(20, 600, threads, order);
+            list_merge_k_parallel(lists.data(), lists.size(), threads);
+            require_merged(lists, order);
+        }
+    }
+}
+
+TEST_CASE("Sorting a list of 10M floats", "[.][benchmark][list_sort]") {
+    const int n = 10000000;
+    list_t *test_list = make_list();
+    unsigned state = 3;
+
+    for(int i = 0; i < n; i++)
+        push_back(test_list, next_value(state));
+
+    BENCHMARK("list_sort") {
+        list_sort(test_list);
+    }
+
+    for(node_t *cur = test_list->head; cur != NULL; cur = next_node(cur))
+        cur->value = next_value(state);
+
+    BENCHMARK("list_sort_parallel, every hardware thread") {
+        list_sort_parallel(test_list, 0);
+    }
+
+    destroy_list(test_list);
+}
+
+TEST_CASE("Merging 1000 sorted lists of 10000 floats", "[.][benchmark][list_sort]") {
+    const size_t k = 1000;
+    const size_t n = 10000000;
+    std::vector<node_t *> order;
+
+    {
+        auto lists = make_sorted_lists(k, n, 7, order);
+        BENCHMARK("list_merge_k") {
+            list_merge_k(lists.data(), k);
+        }
+        for(list_t *list : lists)
+            destroy_list(list);
+    }
+
+    {
+        auto lists = make_sorted_lists(k, n, 7, order);
+        BENCHMARK("list_merge pairwise, in log k rounds") {
+            for(size_t step = 1; step < k; step *= 2)
+                for(size_t i = 0; i + step < k; i += 2 * step)
+                    list_merge(lists[i], lists[i + step]);
+        }
+        for(list_t *list : lists)
+            destroy_list(list);
+    }
+
+    {
+        auto lists = make_sorted_lists(k, n, 7, order);
+        BENCHMARK("list_merge_k_parallel, every hardware thread") {
+            list_merge_k_parallel(lists.data(), k, 0);
+        }
+        for(list_t *list : lists)
+            destroy_list(list);
+    }
+}
@@ -0,0 +1,177 @@
+#include <playground/chops_mpsc_queue.hpp>
+#include <playground/chops_singlylist.hpp>
+#include <catch.hpp>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Producers send p * items_each + i for i = 0, 1, ... and a single
+// consumer checks that each producer's values arrive in order.
+// Returns false on the first out of order value.
+static bool run_mpsc(mpsc_queue_t *queue, int producers, int items_each)
+{
+    const int total = producers * items_each;
+    std::vector<std::thread> threads;
+    std::vector<int> next_expected(producers, 0);
+    bool in_order = true;
+
+    for(int p = 0; p < producers; p++)
+        threads.emplace_back([=] {
+            for(int i = 0; i < items_each; i++)
+                mpsc_enqueue(queue, (float) (p * items_each + i));
+        });
+
+    float batch[64];
+    for(int received = 0; received < total;)
+    {
+        size_t n = mpsc_dequeue_batch(queue, batch, 64);
+        for(size_t i = 0; i < n; i++)
+        {
+            int v = (int) batch[i];
+            int p = v / items_each;
+            if(v % items_each != next_expected[p]++)
+                in_order = false;
+        }
+        received += (int) n;
+    }
+
+    for(auto &t : threads)
+        t.join();
+    return in_order;
+}
+
+TEST_CASE("An MPSC queue", "[mpsc_queue]") {
+
+    SECTION("nodes have the layout of node_t") {
+        REQUIRE(sizeof(cnode_t) == sizeof(node_t));
+    }
+
+    SECTION("is FIFO from a single thread") {
+        mpsc_queue_t *queue = make_mpsc_queue();
+        float val = 0.0f;
+
+        REQUIRE(mpsc_dequeue(queue, &val) == 0);
+        mpsc_enqueue(queue, 1.0f);
+        mpsc_enqueue(queue, 2.0f);
+        mpsc_enqueue(queue, 3.0f);
+
+        REQUIRE(mpsc_dequeue(queue, &val) == 1);
+        REQUIRE(val == Approx(1.0f));
+
+        float batch[8];
+        REQUIRE(mpsc_dequeue_batch(queue, batch, 8) == 2);
+        REQUIRE(batch[0] == Approx(2.0f));
+        REQUIRE(batch[1] == Approx(3.0f));
+        REQUIRE(mpsc_dequeue(queue, &val) == 0);
+
+        SECTION("and recycles dequeued nodes") {
+            cnode_t *spare = tagged_node(queue->spare.load());
+            REQUIRE(spare != NULL);
+            mpsc_enqueue(queue, 4.0f);
+            REQUIRE(queue->head.load() == spare);
+            REQUIRE(mpsc_dequeue(queue, &val) == 1);
+            REQUIRE(val == Approx(4.0f));
+        }
+
+        destroy_mpsc_queue(queue);
+    }
+
+    SECTION("takes spare nodes with a single attempt") {
+        std::atomic<tagged_ptr_t> stack(0);
+        REQUIRE(tagged_try_pop(stack) == NULL);
+
+        cnode_t a, b;
+        tagged_push(stack, &a);
+        tagged_push(stack, &b);
+        REQUIRE(tagged_try_pop(stack) == &b);
+        REQUIRE(tagged_try_pop(stack) == &a);
+        REQUIRE(tagged_try_pop(stack) == NULL);
+    }
+
+    SECTION("keeps each producer's values in order") {
+        mpsc_queue_t *queue = make_mpsc_queue();
+        REQUIRE(run_mpsc(queue, 4, 20000));
+        destroy_mpsc_queue(queue);
+    }
+}
+
+TEST_CASE("MPSC queue throughput and latency", "[.][benchmark][mpsc_queue]") {
+    const int items = 1000000;
+    const int producers = (int) (std::max(2u, std::thread::hardware_concurrency()) - 1);
+
+    {
+        mpsc_queue_t *queue = make_mpsc_queue();
+        std::string name = std::to_string(producers) + " producers, " +
+                           std::to_string(items) + " items, mpsc_queue_t";
+        BENCHMARK(name) {
+            run_mpsc(queue, producers, items / producers);
+        }
+        destroy_mpsc_queue(queue);
+    }
+
+    {
+        // what we had before, push_back and pop from the head under a mutex
+        list_t *list = make_list();
+        std::mutex lock;
+        std::string name = std::to_string(producers) + " producers, " +
+                           std::to_string(items) + " items, list_t and a mutex";
+        BENCHMARK(name) {
+            std::vector<std::thread> threads;
+            for(int p = 0; p < producers; p++)
+                threads.emplace_back([&] {
+                    for(int i = 0; i < items / producers; i++)
+                    {
+                        std::lock_guard<std::mutex> guard(lock);
+                        push_back(list, (float) i);
+                    }
+                });
+            for(int received = 0; received < items / producers * producers;)
+            {
+                std::lock_guard<std::mutex> guard(lock);
+                node_t *node = list->head;
+                if(node == NULL)
+                    continue;
+                list->head = node->next;
+                if(list->head == NULL)
+                    list->tail = NULL;
+                list->length--;
+                free(node);
+                received++;
+            }
+            for(auto &t : threads)
+                t.join();
+        }
+        destroy_list(list);
+    }
+
+    {
+        // one value at a time, the producer waits for the consumer to
+        // see it before sending the next, so this is the hand-off time
+        mpsc_queue_t *queue = make_mpsc_queue();
+        const int round_trips = 100000;
+        std::atomic<int> seen(0);
+        BENCHMARK("hand-off latency, 100000 round trips") {
+            seen = 0;
+            std::thread consumer([&] {
+                float val;
+                for(int i = 0; i < round_trips; i++)
+                {
+                    while(!mpsc_dequeue(queue, &val))
+                        std::this_thread::yield();
+                    seen.store(i + 1, std::memory_order_release);
+                }
+            });
+            for(int i = 0; i < round_trips; i++)
+            {
+                mpsc_enqueue(queue, (float) i);
+                while(seen.load(std::memory_order_acquire) != i + 1)
+                    std::this_thread::yield();
+            }
+            consumer.join();
+        }
+        destroy_mpsc_queue(queue);
+    }
+}
@@ -0,0 +1,96 @@
+#include <playground/chops_parallel_map.hpp>
+#include <catch.hpp>
+#include "list_test_helpers.hpp"
+#include <cmath>
+#include <string>
+#include <vector>
+
+static void busy_node(node_t *n)
+{
+    float v = n->value;
+    for(int i = 0; i < 50; i++)
+        v = std::sqrt(v * v + 1.0f);
+    n->value = v;
+}
+
+static list_t* make_test_list(size_t n)
+{
+    list_t *list = make_list();
+    for(size_t i = 0; i < n; i++)
+        push_back(list, (float) i);
+    return list;
+}
+
+TEST_CASE("parallel_map_each", "[parallel_map_each]") {
+    chops::thread_pool pool(4);
+
+    SECTION("gives the same result as map_each") {
+        for(size_t n : { (size_t) 0, (size_t) 1, (size_t) 7, (size_t) 10001 })
+        {
+            list_t *expected = make_test_list(n);
+            list_t *actual = make_test_list(n);
+
+            map_each(expected, busy_node);
+            parallel_map_each(actual, busy_node, pool);
+            REQUIRE(to_vector(actual) == to_vector(expected));
+
+            destroy_list(expected);
+            destroy_list(actual);
+        }
+    }
+
+    SECTION("can reuse a cached segment index") {
+        list_t *expected = make_test_list(5000);
+        list_t *actual = make_test_list(5000);
+        segment_index_t *index = make_segment_index(actual, 6);
+
+        REQUIRE(index->starts[0] == actual->head);
+        size_t total = 0;
+        for(size_t i = 0; i < index->parts; i++)
+            total += index->counts[i];
+        REQUIRE(total == 5000);
+
+        for(int round = 0; round < 3; round++)
+        {
+            map_each(expected, double_node);
+            parallel_map_each(index, double_node, pool);
+        }
+        REQUIRE(to_vector(actual) == to_vector(expected));
+
+        destroy_segment_index(index);
+        destroy_list(expected);
+        destroy_list(actual);
+    }
+}
+
+TEST_CASE("parallel_map_each scaling", "[.][benchmark][parallel_map_each]") {
+    list_t *test_list = make_test_list(2000000);
+    unsigned max_threads = std::max(1u, std::thread::hardware_concurrency());
+
+    BENCHMARK("map_each") {
+        map_each(test_list, busy_node);
+    }
+
+    // powers of two, and always all cores at the end
+    std::vector<unsigned> steps;
+    for(unsigned threads = 1; threads < max_threads; threads *= 2)
+        steps.push_back(threads);
+    steps.push_back(max_threads);
+
+    for(unsigned threads : steps)
+    {
+        chops::thread_pool pool(threads);
+        std::string name = "parallel_map_each, " + std::to_string(threads) + " threads";
+        BENCHMARK(name) {
+            parallel_map_each(test_list, busy_node, pool);
+        }
+
+        segment_index_t *index = make_segment_index(test_list, threads * 4);
+        name += ", cached segments";
+        BENCHMARK(name) {
+            parallel_map_each(index, busy_node, pool);
+        }
+        destroy_segment_index(index);
+    }
+    destroy_list(test_list);
+}
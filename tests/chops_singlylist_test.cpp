@@ -1,115 +1,466 @@
-#include <playground/chops_singlylist.hpp>
-#include <catch.hpp>
-
-TEST_CASE("A singly linked list", "[singly_list_t]") {
-	
-	SECTION("can be created") {
-        list_t *test_list = make_list();
-		REQUIRE(test_list != NULL);
-
-        SECTION("and initially is empty, head is NULL") {
-		    REQUIRE(test_list->head == NULL);
-	    }
-	}
-
-    SECTION("can be populated with items") {
-        list_t *test_list = make_list();
-        node_t *cur = NULL;
-
-		push_back(test_list, 2.0f);
-	    push_back(test_list, 4.0f);
-	    push_back(test_list, 7.0f);
-	    push_back(test_list, 7.0f);
-        push_back(test_list, 8.0f);
-        push_back(test_list, 12.0f);
-        push_back(test_list, 13.0f);
-        push_back(test_list, 14.0f);
-        
-        cur = test_list->head;
-        REQUIRE(cur->value == Approx(2.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(4.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(7.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(7.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(8.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(12.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(13.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(14.0f));
-        cur = next_node(cur);
-        REQUIRE(cur == NULL);
-	}
-
-    SECTION("but we prefer inserting to front") {
-        list_t *test_list = make_list();
-        node_t *cur = NULL;
-
-		push_front(test_list, 2.0f);
-	    push_front(test_list, 4.0f);
-	    push_front(test_list, 7.0f);
-	    push_front(test_list, 7.0f);
-        push_front(test_list, 8.0f);
-        push_front(test_list, 12.0f);
-        push_front(test_list, 13.0f);
-        push_front(test_list, 14.0f);
-        
-        cur = test_list->head;
-        REQUIRE(cur->value == Approx(14.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(13.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(12.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(8.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(7.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(7.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(4.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(2.0f));
-        cur = next_node(cur);
-        REQUIRE(cur == NULL);
-	}
-
-     SECTION("and can be transformed using map_each") {
-        list_t *test_list = make_list();
-        node_t *cur = NULL;
-
-		push_back(test_list, 2.0f);
-	    push_back(test_list, 4.0f);
-	    push_back(test_list, 7.0f);
-	    push_back(test_list, 7.0f);
-        push_back(test_list, 8.0f);
-        push_back(test_list, 12.0f);
-        push_back(test_list, 13.0f);
-        push_back(test_list, 14.0f);
-
-        map_each(test_list, double_node);
-
-        cur = test_list->head;
-        REQUIRE(cur->value == Approx(4.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(8.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(14.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(14.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(16.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(24.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(26.0f));
-        cur = next_node(cur);
-        REQUIRE(cur->value == Approx(28.0f));
-        cur = next_node(cur);
-        REQUIRE(cur == NULL);
-	}
-}
\ No newline at end of file
+#include <playground/chops_singlylist.hpp>
+#include <catch.hpp>
+#include "list_test_helpers.hpp"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+TEST_CASE("A singly linked list", "[singly_list_t]") {
+	
+	SECTION("can be created") {
+        list_t *test_list = make_list();
+		REQUIRE(test_list != NULL);
+
+        SECTION("and initially is empty, head is NULL") {
+		    REQUIRE(test_list->head == NULL);
+		    REQUIRE(test_list->tail == NULL);
+		    REQUIRE(list_length(test_list) == 0);
+	    }
+	}
+
+    SECTION("can be populated with items") {
+        list_t *test_list = make_list();
+        node_t *cur = NULL;
+
+		push_back(test_list, 2.0f);
+	    push_back(test_list, 4.0f);
+	    push_back(test_list, 7.0f);
+	    push_back(test_list, 7.0f);
+        push_back(test_list, 8.0f);
+        push_back(test_list, 12.0f);
+        push_back(test_list, 13.0f);
+        push_back(test_list, 14.0f);
+        
+        cur = test_list->head;
+        REQUIRE(cur->value == Approx(2.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(4.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(7.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(7.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(8.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(12.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(13.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(14.0f));
+        REQUIRE(cur == test_list->tail);
+        cur = next_node(cur);
+        REQUIRE(cur == NULL);
+        REQUIRE(list_length(test_list) == 8);
+	}
+
+    SECTION("but we prefer inserting to front") {
+        list_t *test_list = make_list();
+        node_t *cur = NULL;
+
+		push_front(test_list, 2.0f);
+	    push_front(test_list, 4.0f);
+	    push_front(test_list, 7.0f);
+	    push_front(test_list, 7.0f);
+        push_front(test_list, 8.0f);
+        push_front(test_list, 12.0f);
+        push_front(test_list, 13.0f);
+        push_front(test_list, 14.0f);
+        
+        cur = test_list->head;
+        REQUIRE(cur->value == Approx(14.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(13.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(12.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(8.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(7.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(7.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(4.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(2.0f));
+        REQUIRE(cur == test_list->tail);
+        cur = next_node(cur);
+        REQUIRE(cur == NULL);
+        REQUIRE(list_length(test_list) == 8);
+	}
+
+    SECTION("or keep it sorted with push_sorted") {
+        list_t *test_list = make_list();
+        node_t *cur = NULL;
+
+        push_sorted(test_list, 7.0f);
+        push_sorted(test_list, 2.0f);
+        push_sorted(test_list, 13.0f);
+        push_sorted(test_list, 4.0f);
+
+        cur = test_list->head;
+        REQUIRE(cur->value == Approx(2.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(4.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(7.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(13.0f));
+        REQUIRE(cur == test_list->tail);
+        REQUIRE(list_length(test_list) == 4);
+
+        SECTION("and its cdr shares the tail and knows its length") {
+            list_t *rest = cdr(test_list);
+            REQUIRE(rest->head == test_list->head->next);
+            REQUIRE(rest->tail == test_list->tail);
+            REQUIRE(list_length(rest) == 3);
+            free(rest);
+        }
+    }
+
+     SECTION("and can be transformed using map_each") {
+        list_t *test_list = make_list();
+        node_t *cur = NULL;
+
+		push_back(test_list, 2.0f);
+	    push_back(test_list, 4.0f);
+	    push_back(test_list, 7.0f);
+	    push_back(test_list, 7.0f);
+        push_back(test_list, 8.0f);
+        push_back(test_list, 12.0f);
+        push_back(test_list, 13.0f);
+        push_back(test_list, 14.0f);
+
+        map_each(test_list, double_node);
+
+        cur = test_list->head;
+        REQUIRE(cur->value == Approx(4.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(8.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(14.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(14.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(16.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(24.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(26.0f));
+        cur = next_node(cur);
+        REQUIRE(cur->value == Approx(28.0f));
+        cur = next_node(cur);
+        REQUIRE(cur == NULL);
+	}
+}
+TEST_CASE("A singly linked list can be built from an array", "[singly_list_t]") {
+    const float values[] = { 2.0f, 4.0f, 7.0f, 7.0f, 8.0f };
+
+    SECTION("with all nodes in one contiguous block") {
+        list_t *test_list = list_from_array(values, 5);
+        node_t *cur = test_list->head;
+
+        REQUIRE(list_length(test_list) == 5);
+        for(int i = 0; i < 5; i++)
+        {
+            REQUIRE(cur == test_list->head + i);
+            REQUIRE(cur->value == Approx(values[i]));
+            cur = next_node(cur);
+        }
+        REQUIRE(cur == NULL);
+        REQUIRE(test_list->tail == test_list->head + 4);
+        destroy_list(test_list);
+    }
+
+    SECTION("and mixed with nodes pushed one by one") {
+        list_t *test_list = make_list();
+
+        push_back(test_list, 1.0f);
+        list_append_array(test_list, values, 5);
+        push_front(test_list, 0.0f);
+        list_append_array(test_list, values, 2);
+        push_back(test_list, 9.0f);
+        list_append_array(test_list, values, 0);
+
+        REQUIRE(list_length(test_list) == 10);
+        const float expected[] = { 0.0f, 1.0f, 2.0f, 4.0f, 7.0f, 7.0f, 8.0f, 2.0f, 4.0f, 9.0f };
+        node_t *cur = test_list->head;
+        for(int i = 0; i < 10; i++)
+        {
+            REQUIRE(cur->value == Approx(expected[i]));
+            cur = next_node(cur);
+        }
+        REQUIRE(test_list->tail->value == Approx(9.0f));
+
+        // destroy_list frees the single nodes and the two blocks
+        destroy_list(test_list);
+    }
+}
+
+// Many small blocks with a single node in front, the nodes of
+// any block can be found next to any other after a shuffle
+static list_t* make_blocky_list(size_t blocks)
+{
+    const float values[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+    list_t *list = make_list();
+    for(size_t i = 0; i < blocks; i++)
+        list_append_array(list, values, 8);
+    push_front(list, -1.0f);
+    return list;
+}
+
+TEST_CASE("Nodes are told apart from the blocks around them", "[singly_list_t]") {
+    list_t *test_list = make_blocky_list(300);
+    for(int i = 0; i < 300; i++)
+        push_back(test_list, (float) i);
+
+    size_t count;
+    block_range_t *ranges = make_block_ranges(test_list, &count);
+    REQUIRE(count == 300);
+    size_t in_blocks = 0;
+    for(node_t *cur = test_list->head; cur != NULL; cur = next_node(cur))
+    {
+        block_range_t *range = find_block_range(ranges, count, cur);
+        if(range != NULL)
+        {
+            REQUIRE((uintptr_t) cur >= range->first);
+            REQUIRE((uintptr_t) cur < range->end);
+            in_blocks++;
+        }
+    }
+    REQUIRE(in_blocks == test_list->block_nodes);
+    free(ranges);
+
+    SECTION("so destroy_list frees only the single nodes") {
+        destroy_list(test_list);
+    }
+
+    SECTION("and so does list_compact") {
+        list_compact(test_list);
+        REQUIRE(list_length(test_list) == 2701);
+        destroy_list(test_list);
+    }
+}
+
+TEST_CASE("A singly linked list can be compacted", "[singly_list_t]") {
+
+    SECTION("keeping its values and their order") {
+        const float values[] = { 3.0f, 5.0f };
+        list_t *test_list = make_list();
+        for(int i = 0; i < 100; i++)
+            push_front(test_list, (float) i);
+        list_append_array(test_list, values, 2);
+        push_sorted(test_list, -1.0f);
+        scatter_list(test_list, 1);
+
+        std::vector<float> before;
+        for(node_t *cur = test_list->head; cur != NULL; cur = next_node(cur))
+            before.push_back(cur->value);
+
+        list_compact(test_list);
+
+        REQUIRE(list_length(test_list) == 103);
+        REQUIRE(test_list->block_nodes == 103);
+        size_t i = 0;
+        for(node_t *cur = test_list->head; cur != NULL; cur = next_node(cur), i++)
+        {
+            REQUIRE(cur == test_list->head + i);
+            REQUIRE(cur->value == before[i]);
+        }
+        REQUIRE(test_list->tail == test_list->head + 102);
+
+        // still a normal list afterwards
+        push_back(test_list, 42.0f);
+        REQUIRE(test_list->tail->value == Approx(42.0f));
+        destroy_list(test_list);
+    }
+
+    SECTION("and an empty list stays empty") {
+        list_t *test_list = make_list();
+        list_compact(test_list);
+        REQUIRE(test_list->head == NULL);
+        REQUIRE(test_list->blocks == NULL);
+        destroy_list(test_list);
+    }
+}
+
+TEST_CASE("Destroying a list of 30k blocks and one single node", "[.][benchmark][singly_list_t]") {
+    BENCHMARK("destroy_list") {
+        destroy_list(make_blocky_list(30000));
+    }
+}
+
+static float traversal_sum(list_t *list)
+{
+    float sum = 0.0f;
+    for(node_t *cur = list->head; cur != NULL; cur = next_node(cur))
+        sum += cur->value;
+    return sum;
+}
+
+TEST_CASE("Traversal before and after list_compact", "[.][benchmark][singly_list_t]") {
+    list_t *test_list = make_list();
+    for(int i = 0; i < 4000000; i++)
+        push_back(test_list, 1.0f);
+    scatter_list(test_list, 7);
+
+    BENCHMARK("traverse 4M scattered nodes") {
+        REQUIRE(traversal_sum(test_list) > 0.0f);
+    }
+
+    BENCHMARK("list_compact") {
+        list_compact(test_list);
+    }
+
+    BENCHMARK("traverse 4M compacted nodes") {
+        REQUIRE(traversal_sum(test_list) > 0.0f);
+    }
+
+    destroy_list(test_list);
+}
+
+TEST_CASE("Singly linked lists can be combined by relinking", "[singly_list_t]") {
+    const float values[] = { 1.0f, 2.0f, 3.0f };
+    list_t *a = list_from_array(values, 3);
+    list_t *b = make_list();
+    push_back(b, 4.0f);
+    push_back(b, 5.0f);
+
+    SECTION("list_concat moves every node of the second list") {
+        node_t *b_head = b->head;
+        list_concat(a, b);
+
+        REQUIRE(to_vector(a) == std::vector<float>{ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f });
+        REQUIRE(a->head->next->next->next == b_head);
+        REQUIRE(a->tail->value == Approx(5.0f));
+        REQUIRE(list_length(a) == 5);
+        REQUIRE(b->head == NULL);
+        REQUIRE(list_length(b) == 0);
+
+        list_concat(b, a);
+        REQUIRE(list_length(b) == 5);
+        REQUIRE(b->block_nodes == 3);
+        REQUIRE(a->blocks == NULL);
+    }
+
+    SECTION("list_splice_after inserts in the middle, front or end") {
+        list_splice_after(a, a->head, b);
+        REQUIRE(to_vector(a) == std::vector<float>{ 1.0f, 4.0f, 5.0f, 2.0f, 3.0f });
+        REQUIRE(list_length(a) == 5);
+
+        push_back(b, 0.0f);
+        list_splice_after(a, NULL, b);
+        REQUIRE(a->head->value == Approx(0.0f));
+
+        push_back(b, 9.0f);
+        list_splice_after(a, a->tail, b);
+        REQUIRE(a->tail->value == Approx(9.0f));
+        REQUIRE(list_length(a) == 7);
+    }
+
+    SECTION("list_split_at cuts a list in two") {
+        list_concat(a, b);
+        list_t *rest = list_split_at(a, 2);
+
+        REQUIRE(to_vector(a) == std::vector<float>{ 1.0f, 2.0f });
+        REQUIRE(to_vector(rest) == std::vector<float>{ 3.0f, 4.0f, 5.0f });
+        REQUIRE(a->tail->next == NULL);
+        REQUIRE(a->tail->value == Approx(2.0f));
+        REQUIRE(list_length(rest) == 3);
+        REQUIRE(a->block_nodes == 2);
+        REQUIRE(rest->block_nodes == 1);
+
+        SECTION("and both halves can be destroyed in either order") {
+            destroy_list(a);
+            push_back(rest, 6.0f);
+            REQUIRE(rest->head->value == Approx(3.0f));
+            a = rest;
+        }
+
+        SECTION("or joined back together") {
+            list_concat(a, rest);
+            REQUIRE(to_vector(a) == std::vector<float>{ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f });
+            destroy_list(rest);
+        }
+
+        SECTION("and splitting past the end gives an empty list") {
+            list_t *empty = list_split_at(rest, 3);
+            REQUIRE(empty->head == NULL);
+            REQUIRE(list_length(rest) == 3);
+            destroy_list(empty);
+            destroy_list(rest);
+        }
+    }
+
+    SECTION("list_reverse reverses in place") {
+        node_t *old_head = a->head;
+        list_reverse(a);
+        REQUIRE(to_vector(a) == std::vector<float>{ 3.0f, 2.0f, 1.0f });
+        REQUIRE(a->tail == old_head);
+        REQUIRE(a->tail->next == NULL);
+    }
+
+    destroy_list(a);
+    destroy_list(b);
+}
+
+static size_t count_block_refs(list_t *list)
+{
+    size_t n = 0;
+    for(block_ref_t *r = list->blocks; r != NULL; r = r->next)
+        n++;
+    return n;
+}
+
+TEST_CASE("Split lists refer only to the blocks they use", "[singly_list_t]") {
+    float values[100];
+    for(int i = 0; i < 100; i++)
+        values[i] = (float) i;
+    list_t *whole = list_from_array(values, 50);
+    list_append_array(whole, values + 50, 50);
+    node_block_t *first_block = whole->blocks_tail->block;
+
+    // ten pieces of ten, only the piece the second block starts in
+    // gets a second reference
+    std::vector<list_t *> pieces;
+    list_t *rest = whole;
+    for(int i = 0; i < 9; i++)
+    {
+        list_t *next = list_split_at(rest, 10);
+        pieces.push_back(rest);
+        rest = next;
+    }
+    pieces.push_back(rest);
+
+    for(size_t i = 0; i < pieces.size(); i++)
+    {
+        REQUIRE(list_length(pieces[i]) == 10);
+        REQUIRE(count_block_refs(pieces[i]) == 1);
+        REQUIRE(pieces[i]->block_nodes == 10);
+        REQUIRE(pieces[i]->head->value == Approx((float) i * 10));
+    }
+    REQUIRE(first_block->refs == 5);
+
+    SECTION("and joining them back keeps the references moving in O(1)") {
+        for(size_t i = 1; i < pieces.size(); i++)
+        {
+            list_concat(pieces[0], pieces[i]);
+            REQUIRE(pieces[i]->blocks_tail == NULL);
+        }
+        REQUIRE(count_block_refs(pieces[0]) == 10);
+        REQUIRE(pieces[0]->blocks_tail->next == NULL);
+
+        SECTION("until a split folds them together again") {
+            list_t *back = list_split_at(pieces[0], 25);
+            REQUIRE(count_block_refs(pieces[0]) == 1);
+            REQUIRE(count_block_refs(back) == 2);
+            REQUIRE(pieces[0]->block_nodes == 25);
+            REQUIRE(back->block_nodes == 75);
+            REQUIRE(first_block->refs == 2);
+            REQUIRE(to_vector(back).front() == Approx(25.0f));
+            destroy_list(back);
+        }
+    }
+
+    for(list_t *piece : pieces)
+        destroy_list(piece);
+}
@@ -0,0 +1,116 @@
+#include <playground/chops_skip_index.hpp>
+#include <catch.hpp>
+
+// Deterministic pseudo random floats in [0, 1000)
+static float next_value(unsigned &state)
+{
+    state = state * 1103515245u + 12345u;
+    return (float) ((state >> 8) % 100000) / 100.0f;
+}
+
+TEST_CASE("A skip index over a sorted list", "[skip_index_t]") {
+
+    SECTION("inserts in the same order as push_sorted") {
+        list_t *plain = make_list();
+        list_t *indexed = make_list();
+        skip_index_t *index = make_skip_index(indexed);
+        unsigned state = 42;
+
+        for(int i = 0; i < 2000; i++)
+        {
+            float val = next_value(state);
+            push_sorted(plain, val);
+            skip_push_sorted(index, val);
+        }
+
+        REQUIRE(list_length(indexed) == list_length(plain));
+        node_t *expected = plain->head;
+        for(node_t *cur = indexed->head; cur != NULL; cur = next_node(cur))
+        {
+            REQUIRE(cur->value == expected->value);
+            if(cur->next == NULL)
+                REQUIRE(cur == indexed->tail);
+            expected = next_node(expected);
+        }
+        REQUIRE(expected == NULL);
+
+        SECTION("and finds the values it holds") {
+            unsigned replay = 42;
+            for(int i = 0; i < 2000; i++)
+            {
+                float val = next_value(replay);
+                node_t *found = skip_find(index, val);
+                REQUIRE(found != NULL);
+                REQUIRE(found->value == val);
+            }
+            REQUIRE(skip_find(index, -1.0f) == NULL);
+            REQUIRE(skip_find(index, 0.005f) == NULL);
+            REQUIRE(skip_find(index, 5000.0f) == NULL);
+        }
+
+        destroy_skip_index(index);
+        destroy_list(indexed);
+        destroy_list(plain);
+    }
+
+    SECTION("can be built over an existing sorted list") {
+        list_t *test_list = make_list();
+        for(int i = 0; i < 500; i++)
+            push_back(test_list, (float) (2 * i));
+
+        skip_index_t *index = make_skip_index(test_list);
+        REQUIRE(skip_find(index, 200.0f) != NULL);
+        REQUIRE(skip_find(index, 201.0f) == NULL);
+
+        skip_push_sorted(index, 201.0f);
+        skip_push_sorted(index, -1.0f);
+        skip_push_sorted(index, 5000.0f);
+
+        REQUIRE(list_length(test_list) == 503);
+        REQUIRE(test_list->head->value == Approx(-1.0f));
+        REQUIRE(test_list->tail->value == Approx(5000.0f));
+        REQUIRE(skip_find(index, 200.0f)->next->value == Approx(201.0f));
+
+        destroy_skip_index(index);
+        destroy_list(test_list);
+    }
+
+    SECTION("keeps equal values in insertion order") {
+        list_t *test_list = make_list();
+        skip_index_t *index = make_skip_index(test_list);
+
+        for(int i = 0; i < 100; i++)
+            skip_push_sorted(index, 1.0f);
+        node_t *first = test_list->head;
+        skip_push_sorted(index, 1.0f);
+
+        REQUIRE(skip_find(index, 1.0f) == first);
+        REQUIRE(test_list->tail->value == Approx(1.0f));
+        REQUIRE(list_length(test_list) == 101);
+
+        destroy_skip_index(index);
+        destroy_list(test_list);
+    }
+}
+
+TEST_CASE("Sorted insert with and without a skip index", "[.][benchmark][skip_index_t]") {
+    const int n = 20000;
+
+    BENCHMARK("push_sorted, 20000 values") {
+        list_t *test_list = make_list();
+        unsigned state = 7;
+        for(int i = 0; i < n; i++)
+            push_sorted(test_list, next_value(state));
+        destroy_list(test_list);
+    }
+
+    BENCHMARK("skip_push_sorted, 20000 values") {
+        list_t *test_list = make_list();
+        skip_index_t *index = make_skip_index(test_list);
+        unsigned state = 7;
+        for(int i = 0; i < n; i++)
+            skip_push_sorted(index, next_value(state));
+        destroy_skip_index(index);
+        destroy_list(test_list);
+    }
+}
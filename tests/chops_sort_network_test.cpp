@@ -0,0 +1,112 @@
+#include <playground/chops_sort_network.hpp>
+#include <catch.hpp>
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Random values with plenty of duplicates and both signs, infinities
+// included for the floating point types
+template <typename T>
+static std::vector<T> random_values(size_t n, std::mt19937 &gen)
+{
+    std::vector<T> v(n);
+    for(auto &x : v)
+        x = (T) ((int) (gen() % 41) - 20);
+    if(n > 2 && std::is_floating_point<T>::value)
+    {
+        v[0] = (T) INFINITY;
+        v[n / 2] = (T) -INFINITY;
+    }
+    return v;
+}
+
+// Checks every size in range against std::sort
+template <typename T, typename F>
+static void require_sorts(F sort, size_t min, size_t max)
+{
+    std::mt19937 gen((unsigned) max);
+    for(size_t n = min; n <= max; n++)
+        for(int round = 0; round < 20; round++)
+        {
+            auto v = random_values<T>(n, gen);
+            auto expected = v;
+            std::sort(expected.begin(), expected.end());
+            sort(v.data(), n);
+            INFO("n = " << n);
+            REQUIRE(v == expected);
+        }
+}
+
+// -0.0 == 0.0, so comparing with a sorted copy can't tell if one
+// of them was duplicated, counting the sign bits can. Tries one
+// zero of either sign among the others at every position.
+template <typename T, typename F>
+static void require_keeps_zeros(F sort, size_t min, size_t max)
+{
+    for(size_t n = min; n <= max; n++)
+        for(size_t odd = 0; odd < n; odd++)
+            for(T zero : { (T) 0.0, (T) -0.0 })
+            {
+                std::vector<T> v(n, zero);
+                v[odd] = -zero;
+                size_t negative = std::count_if(v.begin(), v.end(),
+                                                [](T x) { return std::signbit(x); });
+                sort(v.data(), n);
+                INFO("n = " << n << ", odd one at " << odd);
+                REQUIRE(std::count_if(v.begin(), v.end(),
+                                      [](T x) { return std::signbit(x); }) == (long) negative);
+            }
+}
+
+TEST_CASE("Sorting networks", "[sort_network]") {
+
+    SECTION("sort every size from 8 to 64") {
+        require_sorts<float>([](float *v, size_t n) { REQUIRE(sort_network_float(v, n)); }, 8, 64);
+        require_sorts<int32_t>([](int32_t *v, size_t n) { REQUIRE(sort_network_int32(v, n)); }, 8, 64);
+        require_sorts<double>([](double *v, size_t n) { REQUIRE(sort_network_double(v, n)); }, 8, 64);
+    }
+
+    SECTION("lose neither -0.0 nor 0.0") {
+        require_keeps_zeros<float>([](float *v, size_t n) { REQUIRE(sort_network_float(v, n)); }, 8, 64);
+        require_keeps_zeros<double>([](double *v, size_t n) { REQUIRE(sort_network_double(v, n)); }, 8, 64);
+    }
+
+    SECTION("leave arrays they can't sort alone") {
+        float small[] = { 3.0f, 2.0f, 1.0f };
+        REQUIRE(sort_network_float(small, 3) == 0);
+        REQUIRE(small[0] == 3.0f);
+
+        std::vector<float> big(65, 1.0f);
+        REQUIRE(sort_network_float(big.data(), big.size()) == 0);
+
+        std::vector<double> with_nan{ 5, 4, 3, 2, 1, NAN, 0, -1 };
+        REQUIRE(sort_network_double(with_nan.data(), with_nan.size()) == 0);
+        REQUIRE(with_nan[0] == 5);
+    }
+
+#ifdef CHOPS_SIMD_X86
+    SECTION("have an SSE version for every power of two") {
+        for(size_t n = 8; n <= 64; n *= 2)
+        {
+            require_sorts<float>(sort_network_pow2_sse_float, n, n);
+            require_sorts<int32_t>(sort_network_pow2_sse_int32, n, n);
+            require_sorts<double>(sort_network_pow2_sse_double, n, n);
+            require_keeps_zeros<float>(sort_network_pow2_sse_float, n, n);
+            require_keeps_zeros<double>(sort_network_pow2_sse_double, n, n);
+        }
+    }
+
+    SECTION("and an AVX2 one, if this CPU has AVX2") {
+        if(simd_level() == SIMD_AVX2)
+            for(size_t n = 8; n <= 64; n *= 2)
+            {
+                require_sorts<float>(sort_network_pow2_avx2_float, n, n);
+                require_sorts<int32_t>(sort_network_pow2_avx2_int32, n, n);
+                require_sorts<double>(sort_network_pow2_avx2_double, n, n);
+                require_keeps_zeros<float>(sort_network_pow2_avx2_float, n, n);
+                require_keeps_zeros<double>(sort_network_pow2_avx2_double, n, n);
+            }
+    }
+#endif
+}
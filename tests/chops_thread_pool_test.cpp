@@ -0,0 +1,101 @@
+#include <playground/chops_thread_pool.hpp>
+#include <catch.hpp>
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("A thread pool", "[thread_pool]") {
+
+    SECTION("starts one thread per hardware thread by default") {
+        chops::thread_pool pool;
+        REQUIRE(pool.size() == std::max(1u, std::thread::hardware_concurrency()));
+    }
+
+    SECTION("runs every submitted task") {
+        chops::thread_pool pool(4);
+        std::atomic<int> done(0);
+        std::vector<std::future<void>> pending;
+
+        for(int i = 0; i < 1000; i++)
+            pending.push_back(pool.submit([&done] { done++; }));
+        for(auto &p : pending)
+            p.get();
+        REQUIRE(done == 1000);
+    }
+
+    SECTION("passes exceptions to the future") {
+        chops::thread_pool pool(2);
+        auto f = pool.submit([] { throw std::runtime_error("boom"); });
+        REQUIRE_THROWS_AS(f.get(), std::runtime_error);
+    }
+
+    SECTION("finishes queued tasks before it is destroyed") {
+        std::atomic<int> done(0);
+        {
+            chops::thread_pool pool(1);
+            for(int i = 0; i < 100; i++)
+                pool.submit([&done] { done++; });
+        }
+        REQUIRE(done == 100);
+    }
+}
+
+static long fib(chops::work_stealing_pool &pool, int n)
+{
+    if(n < 2)
+        return n;
+    long a = 0, b = 0;
+    pool.fork_join([&] { a = fib(pool, n - 1); }, [&] { b = fib(pool, n - 2); });
+    return a + b;
+}
+
+TEST_CASE("A work stealing pool", "[thread_pool]") {
+
+    SECTION("runs submitted tasks like thread_pool") {
+        chops::work_stealing_pool pool(4);
+        std::atomic<int> done(0);
+        std::vector<std::future<void>> pending;
+
+        for(int i = 0; i < 1000; i++)
+            pending.push_back(pool.submit([&done] { done++; }));
+        for(auto &p : pending)
+            p.get();
+        REQUIRE(done == 1000);
+        REQUIRE(pool.size() == 4);
+    }
+
+    SECTION("joins nested forks without running out of threads") {
+        for(unsigned threads : { 1u, 2u, 4u })
+        {
+            chops::work_stealing_pool pool(threads);
+            REQUIRE(fib(pool, 20) == 6765);
+
+            // and from inside one of its own tasks
+            long from_task = 0;
+            pool.submit([&] { from_task = fib(pool, 15); }).get();
+            REQUIRE(from_task == 610);
+        }
+    }
+
+    SECTION("passes exceptions from either side of a fork") {
+        chops::work_stealing_pool pool(2);
+        int other_side_ran = 0;
+        REQUIRE_THROWS_AS(pool.fork_join([] { throw std::runtime_error("a"); },
+                                         [&] { other_side_ran++; }),
+                          std::runtime_error);
+        REQUIRE_THROWS_AS(pool.fork_join([&] { other_side_ran++; },
+                                         [] { throw std::logic_error("b"); }),
+                          std::logic_error);
+        REQUIRE(other_side_ran == 2);
+    }
+
+    SECTION("finishes queued tasks before it is destroyed") {
+        std::atomic<int> done(0);
+        {
+            chops::work_stealing_pool pool(1);
+            for(int i = 0; i < 100; i++)
+                pool.submit([&done] { done++; });
+        }
+        REQUIRE(done == 100);
+    }
+}
@@ -0,0 +1,124 @@
+#include <playground/chops_typed_list.hpp>
+#include <playground/chops_singlylist.hpp>
+#include <catch.hpp>
+#include <stdint.h>
+#include <vector>
+
+struct point {
+    int32_t x;
+    int32_t y;
+};
+
+struct alignas(64) cache_line_value {
+    double v;
+};
+
+CHOPS_DECLARE_LIST(i64list, int64_t)
+
+template <typename T>
+static std::vector<T> to_vector(chops::typed_list<T> *list)
+{
+    std::vector<T> out;
+    for(chops::typed_node<T> *cur = list->head; cur != nullptr; cur = chops::next_node(cur))
+        out.push_back(cur->value);
+    return out;
+}
+
+static void double_double(chops::typed_node<double> *n)
+{
+    n->value *= 2;
+}
+
+TEST_CASE("A typed list has no overhead over node_t", "[typed_list]") {
+    REQUIRE(sizeof(chops::typed_node<float>) == sizeof(node_t));
+    REQUIRE(sizeof(i64list_node_t) == sizeof(chops::typed_node<int64_t>));
+}
+
+TEST_CASE("A typed list", "[typed_list]") {
+
+    SECTION("of doubles supports the list_t API") {
+        chops::typed_list<double> *test_list = chops::make_list<double>();
+        REQUIRE(test_list->head == nullptr);
+
+        chops::push_back(test_list, 4.0f);
+        chops::push_back(test_list, 8.0);
+        chops::push_front(test_list, 2.0);
+        chops::push_sorted(test_list, 5.0);
+        chops::push_sorted(test_list, 1.0);
+        chops::push_sorted(test_list, 9.0);
+
+        REQUIRE(to_vector(test_list) == std::vector<double>{ 1.0, 2.0, 4.0, 5.0, 8.0, 9.0 });
+        REQUIRE(chops::list_length(test_list) == 6);
+        REQUIRE(test_list->tail->value == Approx(9.0));
+
+        chops::map_each(test_list, double_double);
+        REQUIRE(chops::car(test_list)->value == Approx(2.0));
+
+        chops::typed_list<double> *rest = chops::cdr(test_list);
+        REQUIRE(rest->head->value == Approx(4.0));
+        REQUIRE(chops::list_length(rest) == 5);
+        delete rest;
+
+        chops::destroy_list(test_list);
+    }
+
+    SECTION("of small structs takes a comparator for push_sorted") {
+        chops::typed_list<point> *test_list = chops::make_list<point>();
+        auto by_x = [](const point &a, const point &b) { return a.x < b.x; };
+
+        chops::push_sorted(test_list, point{ 3, 0 }, by_x);
+        chops::push_sorted(test_list, point{ 1, 0 }, by_x);
+        chops::push_sorted(test_list, point{ 3, 1 }, by_x);
+        chops::push_sorted(test_list, point{ 2, 0 }, by_x);
+
+        std::vector<point> v = to_vector(test_list);
+        REQUIRE(v.size() == 4);
+        REQUIRE(v[0].x == 1);
+        REQUIRE(v[1].x == 2);
+        REQUIRE(v[2].y == 0); // equal keys keep insertion order
+        REQUIRE(v[3].y == 1);
+
+        int sum = 0;
+        chops::map_each(test_list, [&](chops::typed_node<point> *n) { sum += n->value.x; });
+        REQUIRE(sum == 9);
+
+        chops::destroy_list(test_list);
+    }
+
+    SECTION("of over-aligned values keeps them aligned") {
+        chops::typed_list<cache_line_value> *test_list = chops::make_list<cache_line_value>();
+        for(int i = 0; i < 10; i++)
+            chops::push_front(test_list, cache_line_value{ (double) i });
+        for(auto *cur = test_list->head; cur != nullptr; cur = cur->next)
+            REQUIRE((uintptr_t) &cur->value % 64 == 0);
+        chops::destroy_list(test_list);
+    }
+}
+
+TEST_CASE("A list declared with CHOPS_DECLARE_LIST", "[typed_list]") {
+    i64list_t *test_list = i64list_make();
+
+    i64list_push_back(test_list, 7);
+    i64list_push_front(test_list, 2);
+    i64list_push_sorted(test_list, 5);
+    i64list_push_sorted(test_list, INT64_MAX);
+
+    REQUIRE(i64list_length(test_list) == 4);
+    std::vector<int64_t> v;
+    for(i64list_node_t *cur = test_list->head; cur != NULL; cur = cur->next)
+        v.push_back(cur->value);
+    REQUIRE(v == std::vector<int64_t>{ 2, 5, 7, INT64_MAX });
+    REQUIRE(test_list->tail->value == INT64_MAX);
+
+    REQUIRE(i64list_car(test_list)->value == 2);
+    i64list_t *rest = i64list_cdr(test_list);
+    REQUIRE(rest->head->value == 5);
+    REQUIRE(rest->tail == test_list->tail);
+    REQUIRE(i64list_length(rest) == 3);
+    free(rest);
+
+    i64list_map_each(test_list, [](i64list_node_t *n) { n->value -= 1; });
+    REQUIRE(test_list->head->value == 1);
+
+    i64list_destroy(test_list);
+}
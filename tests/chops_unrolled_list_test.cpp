@@ -0,0 +1,180 @@
+#include <playground/chops_unrolled_list.hpp>
+#include <catch.hpp>
+#include <cmath>
+
+TEST_CASE("An unrolled linked list node fits a cache line", "[unrolled_list_t]") {
+    REQUIRE(sizeof(unode_t) == ULIST_CACHE_LINE);
+}
+
+TEST_CASE("An unrolled linked list", "[unrolled_list_t]") {
+
+	SECTION("can be created") {
+        ulist_t *test_list = make_ulist();
+		REQUIRE(test_list != NULL);
+
+        SECTION("and initially is empty, head is NULL") {
+		    REQUIRE(test_list->head == NULL);
+		    REQUIRE(ulist_length(test_list) == 0);
+	    }
+        destroy_ulist(test_list);
+	}
+
+    SECTION("can be populated with more items than a node holds") {
+        ulist_t *test_list = make_ulist();
+        const unsigned n = 3 * ULIST_NODE_CAPACITY + 1;
+
+        for(unsigned i = 0; i < n; i++)
+            ulist_push_back(test_list, (float) i);
+
+        REQUIRE(ulist_length(test_list) == n);
+        REQUIRE(test_list->head->count == ULIST_NODE_CAPACITY);
+        REQUIRE(test_list->tail->count == 1);
+
+        unsigned expected = 0;
+        for(unode_t *cur = test_list->head; cur != NULL; cur = cur->next)
+            for(unsigned i = 0; i < cur->count; i++)
+                REQUIRE(cur->values[i] == Approx((float) expected++));
+        REQUIRE(expected == n);
+        destroy_ulist(test_list);
+	}
+
+    SECTION("and items can be inserted to front") {
+        ulist_t *test_list = make_ulist();
+        const unsigned n = 2 * ULIST_NODE_CAPACITY + 3;
+
+        for(unsigned i = 0; i < n; i++)
+            ulist_push_front(test_list, (float) i);
+
+        REQUIRE(ulist_length(test_list) == n);
+
+        unsigned expected = n;
+        for(unode_t *cur = test_list->head; cur != NULL; cur = cur->next)
+            for(unsigned i = 0; i < cur->count; i++)
+                REQUIRE(cur->values[i] == Approx((float) --expected));
+        REQUIRE(expected == 0);
+        destroy_ulist(test_list);
+	}
+
+    SECTION("and can be transformed using ulist_map_each") {
+        ulist_t *test_list = make_ulist();
+
+        ulist_push_back(test_list, 7.0f);
+        ulist_push_back(test_list, 8.0f);
+        ulist_push_front(test_list, 4.0f);
+        ulist_push_front(test_list, 2.0f);
+
+        ulist_map_each(test_list, double_value);
+
+        unode_t *cur = test_list->head;
+        REQUIRE(cur->count == 4);
+        REQUIRE(cur->values[0] == Approx(4.0f));
+        REQUIRE(cur->values[1] == Approx(8.0f));
+        REQUIRE(cur->values[2] == Approx(14.0f));
+        REQUIRE(cur->values[3] == Approx(16.0f));
+        REQUIRE(cur->next == NULL);
+        destroy_ulist(test_list);
+	}
+}
+
+TEST_CASE("Bulk kernels over an unrolled linked list", "[unrolled_list_t][simd_map]") {
+    ulist_t *test_list = make_ulist();
+    const unsigned n = 4 * ULIST_NODE_CAPACITY + 5;
+
+    for(unsigned i = 0; i < n; i++)
+        ulist_push_back(test_list, (float) i - 20.0f);
+
+    SECTION("ulist_scale gives the same result as map_each with double_value") {
+        ulist_t *expected = make_ulist();
+        for(unsigned i = 0; i < n; i++)
+            ulist_push_back(expected, (float) i - 20.0f);
+        ulist_map_each(expected, double_value);
+
+        ulist_scale(test_list, 2.0f);
+
+        unode_t *e = expected->head;
+        for(unode_t *cur = test_list->head; cur != NULL; cur = cur->next, e = e->next)
+            for(unsigned i = 0; i < cur->count; i++)
+                REQUIRE(cur->values[i] == Approx(e->values[i]));
+        destroy_ulist(expected);
+    }
+
+    SECTION("ulist_add, ulist_fma and ulist_clamp apply to every value") {
+        ulist_add(test_list, 1.0f);
+        ulist_fma(test_list, 3.0f, -1.0f);
+        ulist_clamp(test_list, -10.0f, 10.0f);
+
+        unsigned idx = 0;
+        for(unode_t *cur = test_list->head; cur != NULL; cur = cur->next)
+            for(unsigned i = 0; i < cur->count; i++, idx++)
+            {
+                float v = ((float) idx - 20.0f + 1.0f) * 3.0f - 1.0f;
+                v = v < -10.0f ? -10.0f : (v > 10.0f ? 10.0f : v);
+                REQUIRE(cur->values[i] == Approx(v));
+            }
+        REQUIRE(idx == n);
+    }
+    destroy_ulist(test_list);
+}
+
+// NaN compares unequal to itself, Approx too
+static bool same_result(float actual, float expected)
+{
+    return std::isnan(expected) ? std::isnan(actual) : actual == Approx(expected);
+}
+
+// Inputs with NaN in the vector part and in the tail
+static void fill_kernel_input(float *v, size_t n)
+{
+    for(size_t i = 0; i < n; i++)
+        v[i] = (float) i - 15.0f;
+    v[3] = v[20] = v[n - 1] = NAN;
+}
+
+TEST_CASE("Every SIMD level available agrees with the scalar kernels", "[simd_map]") {
+    const kernel_t kernels[] = {
+        { KERNEL_SCALE, 1.5f, 0.0f },
+        { KERNEL_ADD, -2.25f, 0.0f },
+        { KERNEL_FMA, 0.5f, 3.0f },
+        { KERNEL_CLAMP, -4.0f, 6.0f },
+    };
+    const size_t n = 37; // not a multiple of 8 or 4 to exercise the tails
+
+    REQUIRE(simd_level() != SIMD_UNKNOWN);
+
+    for(const kernel_t &k : kernels)
+    {
+        float expected[n], actual[n];
+        fill_kernel_input(expected, n);
+        fill_kernel_input(actual, n);
+
+        map_block_scalar(expected, n, &k);
+        map_block(actual, n, &k);
+        for(size_t i = 0; i < n; i++)
+            REQUIRE(same_result(actual[i], expected[i]));
+
+#ifdef CHOPS_SIMD_X86
+        fill_kernel_input(actual, n);
+        map_block_sse(actual, n, &k);
+        for(size_t i = 0; i < n; i++)
+            REQUIRE(same_result(actual[i], expected[i]));
+
+        if(simd_level() == SIMD_AVX2)
+        {
+            fill_kernel_input(actual, n);
+            map_block_avx2(actual, n, &k);
+            for(size_t i = 0; i < n; i++)
+                REQUIRE(same_result(actual[i], expected[i]));
+        }
+#endif
+    }
+}
+
+TEST_CASE("Clamping turns NaN into the lower bound", "[simd_map]") {
+    const kernel_t k = { KERNEL_CLAMP, 0.0f, 1.0f };
+    float v[10];
+    for(float &x : v)
+        x = NAN;
+    map_block(v, 10, &k);
+    for(float x : v)
+        REQUIRE(x == 0.0f);
+}
@@ -0,0 +1,46 @@
+#ifndef LIST_TEST_HELPERS_H
+#define LIST_TEST_HELPERS_H
+
+// Helpers shared by the tests of the headers built on list_t
+
+#include <playground/chops_singlylist.hpp>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+inline std::vector<float> to_vector(list_t *list)
+{
+    std::vector<float> out;
+    for(node_t *cur = list->head; cur != NULL; cur = next_node(cur))
+        out.push_back(cur->value);
+    return out;
+}
+
+// Relinks the nodes of list in a random order, so that
+// traversal jumps all over the heap
+inline void scatter_list(list_t *list, unsigned seed)
+{
+    std::vector<node_t *> nodes;
+    for(node_t *cur = list->head; cur != NULL; cur = next_node(cur))
+        nodes.push_back(cur);
+    if(nodes.empty())
+        return;
+    std::shuffle(nodes.begin(), nodes.end(), std::mt19937(seed));
+    for(size_t i = 0; i + 1 < nodes.size(); i++)
+        nodes[i]->next = nodes[i + 1];
+    nodes.back()->next = NULL;
+    list->head = nodes.front();
+    list->tail = nodes.back();
+}
+
+// 0, 1, ..., n - 1 in a random order
+inline list_t* make_scattered_list(size_t n, unsigned seed)
+{
+    list_t *list = make_list();
+    for(size_t i = 0; i < n; i++)
+        push_back(list, (float) i);
+    scatter_list(list, seed);
+    return list;
+}
+
+#endif
@@ -1,149 +1,780 @@
-#include <vector>
-#include <list>
-#include <string>
-#include <array>
-#include <playground/stl_sort_search.hpp>
-#include <catch.hpp>
-
-TEST_CASE("A vector<float> with items { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f }", "[linear_search]") {
-
-	using VecIt = std::vector<float>::const_iterator;
-	std::vector<float> v{ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f };
-
-	SECTION("can be searched for 2.0f, successfully") {
-		VecIt f1 = linear_search(v.begin(), v.end(), 5.2f - 3.2f);
-		REQUIRE(*f1 == Approx(2.0f));
-	}
-
-	SECTION("can be searched for 7.0f, but returns end iterator") {
-		VecIt f1 = linear_search(v.begin(), v.end(), 8.2f - 1.2f);
-		REQUIRE(f1 == v.end());
-	}
-}
-
-TEST_CASE("A list<float> with items { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f }", "[linear_search]") {
-
-	using ListIt = std::list<float>::const_iterator;
-	std::list<float> v{ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f };
-
-	SECTION("can be searched for 2.0f, successfully") {
-		ListIt f1 = linear_search(v.begin(), v.end(), 5.2f - 3.2f);
-		REQUIRE(*f1 == Approx(2.0f));
-	}
-
-	SECTION("can be searched for 7.0f, but returns end iterator") {
-		ListIt f1 = linear_search(v.begin(), v.end(), 8.2f - 1.2f);
-		REQUIRE(f1 == v.end());
-	}
-}
-
-
-TEST_CASE("A vector<std::string> with items { \"Foo\", \"Bar\", \"foo\", \"bar\", \"baz\" }", "[linear_search]") {
-
-	using StrIt = std::vector<std::string>::const_iterator;
-	std::vector<std::string> v{ "Foo", "Bar", "foo", "bar", "baz" };
-
-	SECTION("can be searched for \"baz\", successfully") {
-		StrIt f1 = linear_search(v.begin(), v.end(), "baz");
-		REQUIRE(*f1 == "baz");
-	}
-
-	SECTION("can be searched for \"Baz\", but returns end iterator") {
-		StrIt f1 = linear_search(v.begin(), v.end(), "Baz");
-		REQUIRE(f1 == v.end());
-	}
-}
-
-TEST_CASE("vector<float> of items { 6.0f, 5.0f, 3.0f, 1.0f, 8.0f }", "[insertion_sort]") {
-
-	SECTION("can be sorted with insertion_sort") {
-		std::vector<float> v{ 6.0f, 5.0f, 3.0f, 1.0f, 8.0f };
-		insertion_sort(v.begin(), v.end());
-		REQUIRE(v[0] == Approx(1.0f));
-		REQUIRE(v[1] == Approx(3.0f));
-		REQUIRE(v[2] == Approx(5.0f));
-		REQUIRE(v[3] == Approx(6.0f));
-		REQUIRE(v[4] == Approx(8.0f));
-	}
-
-	SECTION("and insertion_sort do not invalidate the iterators") {
-		using VecIt = std::vector<float>::const_iterator;
-		std::vector<float> v{ 6.0f, 5.0f, 3.0f, 1.0f, 8.0f };
-		VecIt begin_before_sort = v.begin();
-		VecIt end_before_sort = v.end();
-		insertion_sort(v.begin(), v.end());
-		REQUIRE(v.begin() == begin_before_sort);
-		REQUIRE(v.end() == end_before_sort);
-	}
-}
-
-TEST_CASE("vector<std::string> of items { \"Foo\", \"Bar\", \"foo\", \"bar\", \"baz\" }", "[insertion_sort]") {
-
-	SECTION("can be sorted with insertion_sort into lexicographic order") {
-		std::vector<std::string> v{ "Foo", "Bar", "foo", "bar", "baz" };
-		insertion_sort(v.begin(), v.end());
-		REQUIRE(v[0] == "Bar");
-		REQUIRE(v[1] == "Foo");
-		REQUIRE(v[2] == "bar");
-		REQUIRE(v[3] == "baz");
-		REQUIRE(v[4] == "foo");
-	}
-
-	SECTION("and insertion_sort do not invalidate the iterators") {
-		using StrIt = std::vector<std::string>::const_iterator;
-		std::vector<std::string> v{ "Foo", "Bar", "foo", "bar", "baz" };
-		StrIt begin_before_sort = v.begin();
-		StrIt end_before_sort = v.end();
-		insertion_sort(v.begin(), v.end());
-		REQUIRE(v.begin() == begin_before_sort);
-		REQUIRE(v.end() == end_before_sort);
-	}
-}
-
-TEST_CASE("list<float> of items { 6.0f, 5.0f, 3.0f, 1.0f, 8.0f }", "[insertion_sort]") {
-	
-	SECTION("can be sorted with insertion_sort since we require BidirectionalIter") {
-		using ListIt = std::list<float>::iterator;
-		std::list<float> v{ 6.0f, 5.0f, 3.0f, 1.0f, 8.0f };
-		ListIt lit = v.begin();
-		insertion_sort(v.begin(), v.end());
-		REQUIRE(*lit++ == Approx(1.0f));
-		REQUIRE(*lit++ == Approx(3.0f));
-		REQUIRE(*lit++ == Approx(5.0f));
-		REQUIRE(*lit++ == Approx(6.0f));
-		REQUIRE(*lit++ == Approx(8.0f));
-	}
-
-	SECTION("and insertion_sort do not invalidate the iterators") {
-		using ListIt = std::list<float>::iterator;
-		std::list<float> v{ 6.0f, 5.0f, 3.0f, 1.0f, 8.0f };
-		ListIt begin_before_sort = v.begin();
-		ListIt end_before_sort = v.end();
-		insertion_sort(v.begin(), v.end());
-		REQUIRE(v.begin() == begin_before_sort);
-		REQUIRE(v.end() == end_before_sort);
-	}
-}
-
-TEST_CASE("insertion_sort works with normal arrays and pointers", "[insertion_sort]") {
-
-	SECTION("arrays can be sorted with insertion_sort sine pointers are BidirectionalIter") {
-		float  v[] = { 6.0f, 5.0f, 3.0f, 1.0f, 8.0f };
-		insertion_sort(v, v + 5);
-		REQUIRE(v[0] == Approx(1.0f));
-		REQUIRE(v[1] == Approx(3.0f));
-		REQUIRE(v[2] == Approx(5.0f));
-		REQUIRE(v[3] == Approx(6.0f));
-		REQUIRE(v[4] == Approx(8.0f));
-	}
-
-	SECTION("and also works with STL arrays") {
-		std::array<float, 5> v{ 6.0f, 5.0f, 3.0f, 1.0f, 8.0f };
-		insertion_sort(v.begin(), v.end());
-		REQUIRE(v[0] == Approx(1.0f));
-		REQUIRE(v[1] == Approx(3.0f));
-		REQUIRE(v[2] == Approx(5.0f));
-		REQUIRE(v[3] == Approx(6.0f));
-		REQUIRE(v[4] == Approx(8.0f));
-	}
-}
+#include <vector>
+#include <list>
+#include <string>
+#include <array>
+#include <random>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include <playground/stl_sort_search.hpp>
+#include <playground/instrumented.hpp>
+#include <catch.hpp>
+
+// instrumented_test.cpp owns the std::string counts and checks
+// them exactly, so we count with our own type
+template <>
+size_t instrumented<int>::counts[7] = {};
+
+static void reset_counts()
+{
+	std::fill(instrumented<int>::counts, instrumented<int>::counts + 7, 0);
+}
+
+// What insertion_sort used to do, swap the new element left one
+// step at a time. Kept here to compare against.
+template <typename BiderIt>
+void swap_insertion_sort(BiderIt first, BiderIt last)
+{
+	for (BiderIt cur = first; cur != last; ++cur)
+		for (BiderIt inner = cur; inner != first && *inner < *std::prev(inner); --inner)
+			std::iter_swap(std::prev(inner), inner);
+}
+
+// The inputs sorting benchmarks usually look at, n values each
+static std::vector<std::pair<std::string, std::vector<int>>> distributions(size_t n, unsigned seed)
+{
+	std::mt19937 gen(seed);
+	std::vector<std::pair<std::string, std::vector<int>>> out;
+	std::vector<int> v(n);
+
+	for (auto &x : v)
+		x = (int) gen();
+	out.emplace_back("random", v);
+	for (auto &x : v)
+		x = (int) (gen() % 16);
+	out.emplace_back("few unique", v);
+	for (size_t i = 0; i < n; i++)
+		v[i] = (int) i;
+	out.emplace_back("sorted", v);
+	for (size_t i = 0; i < n; i++)
+		v[i] = (int) (n - i);
+	out.emplace_back("reversed", v);
+	for (size_t i = 0; i < n; i++)
+		v[i] = (int) (i < n / 2 ? i : n - i);
+	out.emplace_back("organ pipe", v);
+	for (size_t i = 0; i < n; i++)
+		v[i] = (int) (i % 1000);
+	out.emplace_back("sawtooth", v);
+	for (size_t i = 0; i < n; i++)
+		v[i] = (int) i;
+	for (size_t i = 0; i < n / 100; i++)
+		std::swap(v[gen() % n], v[gen() % n]);
+	out.emplace_back("almost sorted", v);
+	return out;
+}
+
+static std::vector<std::string> random_strings(size_t n, unsigned seed)
+{
+	std::mt19937 gen(seed);
+	std::uniform_int_distribution<int> letter('a', 'z');
+	std::vector<std::string> v(n);
+	for (auto &s : v)
+	{
+		// a shared prefix makes every comparison walk a few characters
+		s = "record-";
+		for (int i = 0; i < 8; i++)
+			s += (char) letter(gen);
+	}
+	return v;
+}
+
+TEST_CASE("A vector<float> with items { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f }", "[linear_search]") {
+
+	using VecIt = std::vector<float>::const_iterator;
+	std::vector<float> v{ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f };
+
+	SECTION("can be searched for 2.0f, successfully") {
+		VecIt f1 = linear_search(v.begin(), v.end(), 5.2f - 3.2f);
+		REQUIRE(*f1 == Approx(2.0f));
+	}
+
+	SECTION("can be searched for 7.0f, but returns end iterator") {
+		VecIt f1 = linear_search(v.begin(), v.end(), 8.2f - 1.2f);
+		REQUIRE(f1 == v.end());
+	}
+}
+
+TEST_CASE("A list<float> with items { 1.0f, 2.0f, 3.0f, 4.0f, 5.0f }", "[linear_search]") {
+
+	using ListIt = std::list<float>::const_iterator;
+	std::list<float> v{ 1.0f, 2.0f, 3.0f, 4.0f, 5.0f };
+
+	SECTION("can be searched for 2.0f, successfully") {
+		ListIt f1 = linear_search(v.begin(), v.end(), 5.2f - 3.2f);
+		REQUIRE(*f1 == Approx(2.0f));
+	}
+
+	SECTION("can be searched for 7.0f, but returns end iterator") {
+		ListIt f1 = linear_search(v.begin(), v.end(), 8.2f - 1.2f);
+		REQUIRE(f1 == v.end());
+	}
+}
+
+
+TEST_CASE("A vector<std::string> with items { \"Foo\", \"Bar\", \"foo\", \"bar\", \"baz\" }", "[linear_search]") {
+
+	using StrIt = std::vector<std::string>::const_iterator;
+	std::vector<std::string> v{ "Foo", "Bar", "foo", "bar", "baz" };
+
+	SECTION("can be searched for \"baz\", successfully") {
+		StrIt f1 = linear_search(v.begin(), v.end(), "baz");
+		REQUIRE(*f1 == "baz");
+	}
+
+	SECTION("can be searched for \"Baz\", but returns end iterator") {
+		StrIt f1 = linear_search(v.begin(), v.end(), "Baz");
+		REQUIRE(f1 == v.end());
+	}
+}
+
+TEST_CASE("branchless searches agree with the standard library", "[binary_search]") {
+
+	SECTION("for every key in and around sorted ints, duplicates included") {
+		for (int n = 0; n < 70; n++)
+		{
+			std::vector<int> v(n);
+			for (int i = 0; i < n; i++)
+				v[i] = i / 3 * 2;
+			for (int key = -2; key <= n; key++)
+			{
+				REQUIRE(branchless_lower_bound(v.begin(), v.end(), key) ==
+						std::lower_bound(v.begin(), v.end(), key));
+				REQUIRE(branchless_upper_bound(v.begin(), v.end(), key) ==
+						std::upper_bound(v.begin(), v.end(), key));
+				REQUIRE(branchless_binary_search(v.begin(), v.end(), key) ==
+						std::binary_search(v.begin(), v.end(), key));
+			}
+		}
+	}
+
+	SECTION("with a comparator and on plain arrays") {
+		int a[] = { 9, 7, 7, 4, 1 };
+		REQUIRE(branchless_lower_bound(a, a + 5, 7, std::greater<>()) == a + 1);
+		REQUIRE(branchless_upper_bound(a, a + 5, 7, std::greater<>()) == a + 3);
+		REQUIRE(branchless_binary_search(a, a + 5, 4, std::greater<>()));
+		REQUIRE_FALSE(branchless_binary_search(a, a + 5, 5, std::greater<>()));
+	}
+
+	SECTION("for strings") {
+		std::vector<std::string> v{ "Bar", "Foo", "bar", "baz", "foo" };
+		REQUIRE(*branchless_lower_bound(v.begin(), v.end(), "baz") == "baz");
+		REQUIRE(branchless_binary_search(v.begin(), v.end(), "foo"));
+		REQUIRE_FALSE(branchless_binary_search(v.begin(), v.end(), "Baz"));
+	}
+}
+
+TEST_CASE("A sorted vector<float> with items { 1.0f, 2.0f, 2.0f, 3.0f, 5.0f }", "[binary_search]") {
+
+	using VecIt = std::vector<float>::const_iterator;
+	std::vector<float> v{ 1.0f, 2.0f, 2.0f, 3.0f, 5.0f };
+
+	SECTION("can be searched for 2.0f, successfully") {
+		REQUIRE(branchless_binary_search(v.begin(), v.end(), 5.2f - 3.2f));
+		VecIt lo = branchless_lower_bound(v.begin(), v.end(), 5.2f - 3.2f);
+		VecIt hi = branchless_upper_bound(v.begin(), v.end(), 5.2f - 3.2f);
+		REQUIRE(lo - v.begin() == 1);
+		REQUIRE(hi - v.begin() == 3);
+	}
+
+	SECTION("can be searched for 4.0f, but it is not there") {
+		REQUIRE_FALSE(branchless_binary_search(v.begin(), v.end(), 4.0f));
+		REQUIRE(*branchless_lower_bound(v.begin(), v.end(), 4.0f) == Approx(5.0f));
+	}
+
+	SECTION("can be searched for 7.0f, but returns end iterator") {
+		REQUIRE_FALSE(branchless_binary_search(v.begin(), v.end(), 8.2f - 1.2f));
+		REQUIRE(branchless_lower_bound(v.begin(), v.end(), 8.2f - 1.2f) == v.end());
+	}
+}
+
+TEST_CASE("vector<float> of items { 6.0f, 5.0f, 3.0f, 1.0f, 8.0f }", "[insertion_sort]") {
+
+	SECTION("can be sorted with insertion_sort") {
+		std::vector<float> v{ 6.0f, 5.0f, 3.0f, 1.0f, 8.0f };
+		insertion_sort(v.begin(), v.end());
+		REQUIRE(v[0] == Approx(1.0f));
+		REQUIRE(v[1] == Approx(3.0f));
+		REQUIRE(v[2] == Approx(5.0f));
+		REQUIRE(v[3] == Approx(6.0f));
+		REQUIRE(v[4] == Approx(8.0f));
+	}
+
+	SECTION("and insertion_sort do not invalidate the iterators") {
+		using VecIt = std::vector<float>::const_iterator;
+		std::vector<float> v{ 6.0f, 5.0f, 3.0f, 1.0f, 8.0f };
+		VecIt begin_before_sort = v.begin();
+		VecIt end_before_sort = v.end();
+		insertion_sort(v.begin(), v.end());
+		REQUIRE(v.begin() == begin_before_sort);
+		REQUIRE(v.end() == end_before_sort);
+	}
+}
+
+TEST_CASE("vector<std::string> of items { \"Foo\", \"Bar\", \"foo\", \"bar\", \"baz\" }", "[insertion_sort]") {
+
+	SECTION("can be sorted with insertion_sort into lexicographic order") {
+		std::vector<std::string> v{ "Foo", "Bar", "foo", "bar", "baz" };
+		insertion_sort(v.begin(), v.end());
+		REQUIRE(v[0] == "Bar");
+		REQUIRE(v[1] == "Foo");
+		REQUIRE(v[2] == "bar");
+		REQUIRE(v[3] == "baz");
+		REQUIRE(v[4] == "foo");
+	}
+
+	SECTION("and insertion_sort do not invalidate the iterators") {
+		using StrIt = std::vector<std::string>::const_iterator;
+		std::vector<std::string> v{ "Foo", "Bar", "foo", "bar", "baz" };
+		StrIt begin_before_sort = v.begin();
+		StrIt end_before_sort = v.end();
+		insertion_sort(v.begin(), v.end());
+		REQUIRE(v.begin() == begin_before_sort);
+		REQUIRE(v.end() == end_before_sort);
+	}
+}
+
+TEST_CASE("list<float> of items { 6.0f, 5.0f, 3.0f, 1.0f, 8.0f }", "[insertion_sort]") {
+	
+	SECTION("can be sorted with insertion_sort since we require BidirectionalIter") {
+		using ListIt = std::list<float>::iterator;
+		std::list<float> v{ 6.0f, 5.0f, 3.0f, 1.0f, 8.0f };
+		ListIt lit = v.begin();
+		insertion_sort(v.begin(), v.end());
+		REQUIRE(*lit++ == Approx(1.0f));
+		REQUIRE(*lit++ == Approx(3.0f));
+		REQUIRE(*lit++ == Approx(5.0f));
+		REQUIRE(*lit++ == Approx(6.0f));
+		REQUIRE(*lit++ == Approx(8.0f));
+	}
+
+	SECTION("and insertion_sort do not invalidate the iterators") {
+		using ListIt = std::list<float>::iterator;
+		std::list<float> v{ 6.0f, 5.0f, 3.0f, 1.0f, 8.0f };
+		ListIt begin_before_sort = v.begin();
+		ListIt end_before_sort = v.end();
+		insertion_sort(v.begin(), v.end());
+		REQUIRE(v.begin() == begin_before_sort);
+		REQUIRE(v.end() == end_before_sort);
+	}
+}
+
+TEST_CASE("insertion_sort works with normal arrays and pointers", "[insertion_sort]") {
+
+	SECTION("arrays can be sorted with insertion_sort sine pointers are BidirectionalIter") {
+		float  v[] = { 6.0f, 5.0f, 3.0f, 1.0f, 8.0f };
+		insertion_sort(v, v + 5);
+		REQUIRE(v[0] == Approx(1.0f));
+		REQUIRE(v[1] == Approx(3.0f));
+		REQUIRE(v[2] == Approx(5.0f));
+		REQUIRE(v[3] == Approx(6.0f));
+		REQUIRE(v[4] == Approx(8.0f));
+	}
+
+	SECTION("and also works with STL arrays") {
+		std::array<float, 5> v{ 6.0f, 5.0f, 3.0f, 1.0f, 8.0f };
+		insertion_sort(v.begin(), v.end());
+		REQUIRE(v[0] == Approx(1.0f));
+		REQUIRE(v[1] == Approx(3.0f));
+		REQUIRE(v[2] == Approx(5.0f));
+		REQUIRE(v[3] == Approx(6.0f));
+		REQUIRE(v[4] == Approx(8.0f));
+	}
+}
+
+TEST_CASE("insertion_sort variants for random access ranges", "[insertion_sort]") {
+
+	SECTION("are stable") {
+		std::vector<std::pair<int, int>> v;
+		for (int i = 0; i < 100; i++)
+			v.emplace_back((i * 7) % 10, i);
+		auto by_key = [](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+			return a.first < b.first;
+		};
+		auto w = v;
+		std::stable_sort(v.begin(), v.end(), by_key);
+
+		auto u = w;
+		insertion_sort(u.begin(), u.end(), by_key);
+		REQUIRE(u == v);
+		binary_insertion_sort(w.begin(), w.end(), by_key);
+		REQUIRE(w == v);
+	}
+
+	SECTION("unguarded_insertion_sort relies on an element before first") {
+		std::vector<float> v{ 0.0f, 6.0f, 5.0f, 3.0f, 1.0f, 8.0f, 1.0f };
+		unguarded_insertion_sort(v.begin() + 1, v.end());
+		REQUIRE(std::is_sorted(v.begin(), v.end()));
+		REQUIRE(v[0] == Approx(0.0f));
+	}
+
+	SECTION("binary_insertion_sort sorts strings and empty ranges") {
+		std::vector<std::string> v{ "Foo", "Bar", "foo", "bar", "baz" };
+		binary_insertion_sort(v.begin(), v.end());
+		REQUIRE(v == std::vector<std::string>{ "Bar", "Foo", "bar", "baz", "foo" });
+		binary_insertion_sort(v.begin(), v.begin());
+		float a[] = { 3.0f, 2.0f };
+		binary_insertion_sort(a, a + 2, std::greater<>());
+		REQUIRE(a[0] == Approx(3.0f));
+	}
+
+	SECTION("move instead of swapping, and binary search for the place") {
+		std::vector<instrumented<int>> input;
+		std::mt19937 gen(42);
+		for (int i = 0; i < 200; i++)
+			input.emplace_back((int) (gen() % 1000));
+
+		auto v = input;
+		reset_counts();
+		swap_insertion_sort(v.begin(), v.end());
+		size_t swap_compares = instrumented<int>::comparison_count();
+		size_t swap_moves = instrumented<int>::assignment_count() + instrumented<int>::copy_const_count();
+
+		v = input;
+		reset_counts();
+		insertion_sort(v.begin(), v.end());
+		size_t linear_compares = instrumented<int>::comparison_count();
+		size_t linear_moves = instrumented<int>::assignment_count() + instrumented<int>::copy_const_count();
+		REQUIRE(std::is_sorted(v.begin(), v.end()));
+
+		v = input;
+		reset_counts();
+		binary_insertion_sort(v.begin(), v.end());
+		size_t binary_compares = instrumented<int>::comparison_count();
+		size_t binary_moves = instrumented<int>::assignment_count() + instrumented<int>::copy_const_count();
+		REQUIRE(std::is_sorted(v.begin(), v.end()));
+
+		// a swap is three moves, shifting is one
+		REQUIRE(linear_moves * 2 < swap_moves);
+		REQUIRE(linear_compares == swap_compares);
+		// about n log n instead of n^2 / 4 comparisons
+		REQUIRE(binary_compares * 5 < linear_compares);
+		REQUIRE(binary_moves == linear_moves);
+	}
+}
+
+TEST_CASE("Insertion sorting 2000 strings", "[.][benchmark][insertion_sort]") {
+	const auto input = random_strings(2000, 7);
+	std::vector<std::string> v;
+
+	BENCHMARK("swapping, like insertion_sort used to") {
+		v = input;
+		swap_insertion_sort(v.begin(), v.end());
+	}
+
+	BENCHMARK("insertion_sort") {
+		v = input;
+		insertion_sort(v.begin(), v.end());
+	}
+
+	BENCHMARK("binary_insertion_sort") {
+		v = input;
+		binary_insertion_sort(v.begin(), v.end());
+	}
+}
+
+TEST_CASE("pdqsort sorts like std::sort", "[pdqsort]") {
+
+	SECTION("on every distribution and size") {
+		for (size_t n : { 0, 1, 2, 5, 23, 24, 25, 100, 129, 1000, 20000 })
+			for (auto &d : distributions(n, (unsigned) n))
+			{
+				auto v = d.second;
+				auto expected = d.second;
+				std::sort(expected.begin(), expected.end());
+				pdqsort(v.begin(), v.end());
+				INFO(d.first << ", n = " << n);
+				REQUIRE(v == expected);
+
+				// with a comparator that is not block partitioned
+				v = d.second;
+				pdqsort(v.begin(), v.end(), [](int a, int b) { return a > b; });
+				REQUIRE(std::equal(v.begin(), v.end(), expected.rbegin()));
+			}
+	}
+
+	SECTION("with std::greater, on floats and on strings") {
+		std::vector<float> f{ 6.0f, 5.0f, 3.0f, 1.0f, 8.0f, 3.0f, -2.0f };
+		pdqsort(f.begin(), f.end(), std::greater<>());
+		REQUIRE(std::is_sorted(f.begin(), f.end(), std::greater<>()));
+
+		auto v = random_strings(5000, 3);
+		auto expected = v;
+		std::sort(expected.begin(), expected.end());
+		pdqsort(v.begin(), v.end());
+		REQUIRE(v == expected);
+	}
+
+	SECTION("and stays n log n when the pivots are bad") {
+		// interleaved rising and falling values, counted comparisons
+		// must stay near n log n
+		std::vector<instrumented<int>> v;
+		const int n = 1 << 14;
+		for (int i = 0; i < n; i++)
+			v.emplace_back(i % 2 ? i : n - i);
+		reset_counts();
+		pdqsort(v.begin(), v.end());
+		REQUIRE(std::is_sorted(v.begin(), v.end()));
+		REQUIRE(instrumented<int>::comparison_count() < (size_t) n * 14 * 4);
+	}
+}
+
+TEST_CASE("pdqsort against std::sort, 1M ints", "[.][benchmark][pdqsort]") {
+	for (auto &d : distributions(1000000, 11))
+	{
+		std::vector<int> v;
+		std::string std_name = "std::sort, " + d.first;
+		std::string pdq_name = "pdqsort, " + d.first;
+		BENCHMARK(std_name) {
+			v = d.second;
+			std::sort(v.begin(), v.end());
+		}
+		BENCHMARK(pdq_name) {
+			v = d.second;
+			pdqsort(v.begin(), v.end());
+		}
+	}
+
+	auto strings = random_strings(200000, 5);
+	std::vector<std::string> v;
+	BENCHMARK("std::sort, 200k strings") {
+		v = strings;
+		std::sort(v.begin(), v.end());
+	}
+	BENCHMARK("pdqsort, 200k strings") {
+		v = strings;
+		pdqsort(v.begin(), v.end());
+	}
+}
+
+TEST_CASE("parallel_merge_sort is a stable sort", "[parallel_merge_sort]") {
+
+	SECTION("on every distribution, with any number of threads") {
+		for (unsigned threads : { 1u, 2u, 3u, 4u })
+		{
+			chops::work_stealing_pool pool(threads);
+			for (size_t n : { 0, 1, 2, 31, 32, 33, 1000, 100000 })
+				for (auto &d : distributions(n, (unsigned) n + threads))
+				{
+					auto v = d.second;
+					auto expected = d.second;
+					std::sort(expected.begin(), expected.end());
+					parallel_merge_sort(pool, v.begin(), v.end());
+					INFO(d.first << ", n = " << n << ", threads = " << threads);
+					REQUIRE(v == expected);
+				}
+		}
+	}
+
+	SECTION("keeping equal elements in order") {
+		std::vector<std::pair<int, int>> v;
+		std::mt19937 gen(1);
+		for (int i = 0; i < 200000; i++)
+			v.emplace_back((int) (gen() % 100), i);
+		auto by_key = [](const std::pair<int, int> &a, const std::pair<int, int> &b) {
+			return a.first < b.first;
+		};
+		auto expected = v;
+		std::stable_sort(expected.begin(), expected.end(), by_key);
+		parallel_merge_sort(v.begin(), v.end(), by_key);
+		REQUIRE(v == expected);
+	}
+
+	SECTION("on strings and plain arrays") {
+		auto v = random_strings(50000, 9);
+		auto expected = v;
+		std::sort(expected.begin(), expected.end(), std::greater<>());
+		parallel_merge_sort(v.begin(), v.end(), std::greater<>());
+		REQUIRE(v == expected);
+
+		float a[] = { 6.0f, 5.0f, 3.0f, 1.0f, 8.0f };
+		parallel_merge_sort(a, a + 5);
+		REQUIRE(std::is_sorted(a, a + 5));
+	}
+}
+
+TEST_CASE("parallel_merge_sort scaling, 10M ints", "[.][benchmark][parallel_merge_sort]") {
+	const auto input = distributions(10000000, 13)[0].second;
+	std::vector<int> v;
+
+	BENCHMARK("std::stable_sort") {
+		v = input;
+		std::stable_sort(v.begin(), v.end());
+	}
+
+	const unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+	std::vector<unsigned> steps;
+	for (unsigned threads = 1; threads < hardware; threads *= 2)
+		steps.push_back(threads);
+	steps.push_back(hardware);
+
+	for (unsigned threads : steps)
+	{
+		chops::work_stealing_pool pool(threads);
+		std::string name = "parallel_merge_sort, " + std::to_string(threads) + " threads";
+		BENCHMARK(name) {
+			v = input;
+			parallel_merge_sort(pool, v.begin(), v.end());
+		}
+	}
+}
+
+TEST_CASE("insertion_sort uses sorting networks for small numeric arrays", "[insertion_sort]") {
+	std::mt19937 gen(17);
+
+	SECTION("for vectors and plain arrays of 8 to 64 values") {
+		for (size_t n = 8; n <= 64; n++)
+		{
+			std::vector<float> f(n);
+			std::vector<double> d(n);
+			int32_t a[64];
+			for (size_t i = 0; i < n; i++)
+			{
+				f[i] = (float) (gen() % 100) - 50.0f;
+				d[i] = (double) (gen() % 100) / 7;
+				a[i] = (int32_t) gen();
+			}
+			insertion_sort(f.begin(), f.end());
+			insertion_sort(d.begin(), d.end(), std::less<double>());
+			insertion_sort(a, a + n);
+			REQUIRE(std::is_sorted(f.begin(), f.end()));
+			REQUIRE(std::is_sorted(d.begin(), d.end()));
+			REQUIRE(std::is_sorted(a, a + n));
+		}
+	}
+
+	SECTION("and still sorts what they can't, like NaNs") {
+		std::vector<float> v{ 6.0f, 5.0f, NAN, 1.0f, 8.0f, 2.0f, 7.0f, 3.0f, 4.0f };
+		insertion_sort(v.begin(), v.end());
+		REQUIRE(std::count_if(v.begin(), v.end(), [](float x) { return x != x; }) == 1);
+		REQUIRE(std::is_sorted(v.begin() + 3, v.end()));
+	}
+
+	SECTION("but stay stable for -0.0 and 0.0, which compare equal") {
+		std::vector<float> zeros(32);
+		for (size_t i = 0; i < zeros.size(); i++)
+			zeros[i] = i % 2 ? -0.0f : 0.0f;
+		std::vector<float> mixed(40);
+		for (size_t i = 0; i < mixed.size(); i++)
+			mixed[i] = i % 5 == 0 ? (i % 2 ? -0.0f : 0.0f) : (float) (gen() % 7) - 3.0f;
+
+		auto same_bits = [](const std::vector<float> &a, const std::vector<float> &b) {
+			return std::memcmp(a.data(), b.data(), a.size() * sizeof(float)) == 0;
+		};
+		for (const auto &v : { zeros, mixed })
+		{
+			auto expected = v;
+			std::stable_sort(expected.begin(), expected.end());
+
+			auto sorted = v;
+			insertion_sort(sorted.begin(), sorted.end());
+			REQUIRE(same_bits(sorted, expected));
+
+			sorted = v;
+			parallel_merge_sort(sorted.begin(), sorted.end());
+			REQUIRE(same_bits(sorted, expected));
+		}
+	}
+
+	SECTION("without losing -0.0 or 0.0, which compare equal") {
+		auto negative_zeros = [](const std::vector<double> &v) {
+			return std::count_if(v.begin(), v.end(), [](double x) { return x == 0 && std::signbit(x); });
+		};
+		for (size_t n : { (size_t) 16, (size_t) 33, (size_t) 64, (size_t) 200000 })
+		{
+			std::vector<double> v(n, 0.0);
+			for (size_t i = 0; i < n; i++)
+				if (gen() % 3 == 0)
+					v[i] = gen() % 2 ? -0.0 : (double) (gen() % 5);
+			const auto expected = negative_zeros(v);
+
+			std::vector<double> sorted = v;
+			if (n <= 64)
+				insertion_sort(sorted.begin(), sorted.end());
+			else
+				pdqsort(sorted.begin(), sorted.end());
+			REQUIRE(negative_zeros(sorted) == expected);
+
+			sorted = v;
+			parallel_merge_sort(sorted.begin(), sorted.end());
+			REQUIRE(negative_zeros(sorted) == expected);
+		}
+	}
+}
+
+TEST_CASE("Sorting 100k small float arrays", "[.][benchmark][insertion_sort]") {
+	std::mt19937 gen(19);
+	std::vector<std::vector<float>> input(100000);
+	for (auto &v : input)
+	{
+		v.resize(8 + gen() % 57);
+		for (auto &x : v)
+			x = (float) (gen() % 10000);
+	}
+	auto work = input;
+
+	BENCHMARK("insertion_sort, scalar") {
+		work = input;
+		for (auto &v : work)
+			insertion_sort(v.begin(), v.end(), [](float a, float b) { return a < b; });
+	}
+
+	BENCHMARK("insertion_sort, sorting networks") {
+		work = input;
+		for (auto &v : work)
+			insertion_sort(v.begin(), v.end());
+	}
+
+	BENCHMARK("std::sort") {
+		work = input;
+		for (auto &v : work)
+			std::sort(v.begin(), v.end());
+	}
+}
+
+template <typename T>
+static std::vector<T> random_keys(size_t n, unsigned seed)
+{
+	std::mt19937_64 gen(seed);
+	std::vector<T> v(n);
+	for (auto &x : v)
+	{
+		uint64_t r = gen();
+		if (std::is_floating_point<T>::value)
+			x = (T) ((double) (int64_t) r / (double) (1ull << (gen() % 64)));
+		else
+			std::memcpy(&x, &r, sizeof(T));
+	}
+	return v;
+}
+
+template <typename T>
+static void require_radix_sorts(chops::work_stealing_pool &pool, size_t n, unsigned seed)
+{
+	auto v = random_keys<T>(n, seed);
+	auto expected = v;
+	std::sort(expected.begin(), expected.end());
+	radix_sort(pool, v.begin(), v.end());
+	REQUIRE(v == expected);
+}
+
+TEST_CASE("radix_sort sorts integer and floating point keys", "[radix_sort]") {
+	chops::work_stealing_pool pool(3);
+
+	SECTION("of every width and signedness") {
+		for (size_t n : { 0, 1, 2, 100, 5000, 300000 })
+		{
+			INFO("n = " << n);
+			require_radix_sorts<int8_t>(pool, n, 1);
+			require_radix_sorts<uint16_t>(pool, n, 2);
+			require_radix_sorts<int32_t>(pool, n, 3);
+			require_radix_sorts<uint32_t>(pool, n, 4);
+			require_radix_sorts<int64_t>(pool, n, 5);
+			require_radix_sorts<uint64_t>(pool, n, 6);
+			require_radix_sorts<float>(pool, n, 7);
+			require_radix_sorts<double>(pool, n, 8);
+		}
+	}
+
+	SECTION("with negatives, infinities and both zeros in order") {
+		float f[] = { 3.5f, -0.0f, -1.0f, INFINITY, 0.0f, -INFINITY, -1e-30f, 1e-30f, -2.5f };
+		radix_sort(f, f + 9);
+		REQUIRE(std::is_sorted(f, f + 9));
+		REQUIRE(std::signbit(f[4]));
+		REQUIRE(!std::signbit(f[5]));
+
+		std::vector<double> d{ -0.0, 0.0, -0.0, 1.0, -1.0 };
+		radix_sort(d.begin(), d.end());
+		REQUIRE(std::signbit(d[1]));
+		REQUIRE(std::signbit(d[2]));
+		REQUIRE(!std::signbit(d[3]));
+	}
+
+	SECTION("and records by a key, stably") {
+		struct record { int32_t id; float score; };
+		std::vector<record> v;
+		std::mt19937 gen(3);
+		for (int i = 0; i < 100000; i++)
+			v.push_back({ i, (float) (gen() % 200) - 100.0f });
+
+		auto expected = v;
+		auto by_score = [](const record &a, const record &b) { return a.score < b.score; };
+		std::stable_sort(expected.begin(), expected.end(), by_score);
+		radix_sort(pool, v.begin(), v.end(), [](const record &r) { return r.score; });
+		std::vector<int32_t> ids, expected_ids;
+		for (size_t i = 0; i < v.size(); i++)
+		{
+			ids.push_back(v[i].id);
+			expected_ids.push_back(expected[i].id);
+		}
+		REQUIRE(ids == expected_ids);
+	}
+
+	SECTION("with small keys in a wide type") {
+		std::vector<uint64_t> v{ 5, 3, 9, 1 };
+		radix_sort(v.begin(), v.end());
+		REQUIRE(v == std::vector<uint64_t>{ 1, 3, 5, 9 });
+	}
+}
+
+TEST_CASE("radix_sort against comparison sorts, 10M keys", "[.][benchmark][radix_sort]") {
+	const auto ints = random_keys<uint32_t>(10000000, 21);
+	const auto floats = random_keys<float>(10000000, 22);
+	std::vector<uint32_t> vi;
+	std::vector<float> vf;
+
+	BENCHMARK("std::sort, uint32_t") {
+		vi = ints;
+		std::sort(vi.begin(), vi.end());
+	}
+	BENCHMARK("pdqsort, uint32_t") {
+		vi = ints;
+		pdqsort(vi.begin(), vi.end());
+	}
+	BENCHMARK("radix_sort, uint32_t") {
+		vi = ints;
+		radix_sort(vi.begin(), vi.end());
+	}
+	BENCHMARK("std::sort, float") {
+		vf = floats;
+		std::sort(vf.begin(), vf.end());
+	}
+	BENCHMARK("radix_sort, float") {
+		vf = floats;
+		radix_sort(vf.begin(), vf.end());
+	}
+}
+
+// Sizes from L1 to well past the last level cache, the largest is
+// 1 GB of ints
+TEST_CASE("Branchless binary search against std::lower_bound", "[.][benchmark][binary_search]") {
+	const size_t lookups = 1000000;
+	std::mt19937 gen(31);
+
+	for (size_t bytes : { (size_t) 32 << 10, (size_t) 1 << 20, (size_t) 32 << 20, (size_t) 1 << 30 })
+	{
+		const size_t n = bytes / sizeof(int);
+		std::vector<int> v(n);
+		for (size_t i = 0; i < n; i++)
+			v[i] = (int) (i * 2);
+		std::uniform_int_distribution<int> key(0, (int) (n * 2));
+		std::vector<int> keys(lookups);
+		for (int &k : keys)
+			k = key(gen);
+
+		static size_t found;
+		const std::string size = std::to_string(bytes >> 10) + " KB";
+		const std::string std_name = "std::lower_bound, " + size;
+		const std::string branchless_name = "branchless_lower_bound, " + size;
+
+		BENCHMARK(std_name) {
+			found = 0;
+			for (int k : keys)
+				found += std::lower_bound(v.begin(), v.end(), k) - v.begin();
+		}
+		BENCHMARK(branchless_name) {
+			found = 0;
+			for (int k : keys)
+				found += branchless_lower_bound(v.begin(), v.end(), k) - v.begin();
+		}
+	}
+}
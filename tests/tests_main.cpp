@@ -1,4 +1,7 @@
-// Let Catch provide main() :
-#define CATCH_CONFIG_MAIN
-
+// Let Catch provide main() :
+#define CATCH_CONFIG_MAIN
+// Catch 2.1 sizes its signal stack with SIGSTKSZ, which is no longer
+// a constant on recent glibc, so we opt out of its signal handlers
+#define CATCH_CONFIG_NO_POSIX_SIGNALS
+
 #include "catch.hpp"
\ No newline at end of file